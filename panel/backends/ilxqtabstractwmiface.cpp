@@ -28,10 +28,107 @@
 
 #include "ilxqtabstractwmiface.h"
 
+#include <QMetaMethod>
+#include <QTimer>
+
 ILXQtAbstractWMInterface::ILXQtAbstractWMInterface(QObject *parent)
     : QObject(parent)
+    , m_propertiesTimer(new QTimer(this))
+{
+    m_propertiesTimer->setSingleShot(true);
+    m_propertiesTimer->setInterval(0);
+    connect(m_propertiesTimer, &QTimer::timeout, this, &ILXQtAbstractWMInterface::flushWindowProperties);
+
+    connect(this, &ILXQtAbstractWMInterface::windowPropertyChanged, this, &ILXQtAbstractWMInterface::queueWindowProperty);
+    connect(this, &ILXQtAbstractWMInterface::windowRemoved, this, [this] (WId windowId) {
+        if (m_pendingProperties.remove(windowId))
+            m_pendingWindows.removeOne(windowId);
+    });
+    connect(this, &ILXQtAbstractWMInterface::reloaded, this, [this] {
+        m_pendingWindows.clear();
+        m_pendingProperties.clear();
+    });
+}
+
+int ILXQtAbstractWMInterface::getSupportedActions(WId windowId) const
+{
+    int actions = 0;
+    for (int action = int(LXQtTaskBarBackendAction::Move); action <= int(LXQtTaskBarBackendAction::MoveToOutput); ++action)
+    {
+        if (supportsAction(windowId, LXQtTaskBarBackendAction(action)))
+            actions |= backendActionBit(LXQtTaskBarBackendAction(action));
+    }
+    return actions;
+}
+
+void ILXQtAbstractWMInterface::queueWindowProperty(WId windowId, int prop)
 {
+    if (m_announcing)
+        return;
+
+    // don't collect anything if nobody listens
+    static const QMetaMethod coalescedSignal = QMetaMethod::fromSignal(&ILXQtAbstractWMInterface::windowPropertiesChanged);
+    static const QMetaMethod snapshotSignal = QMetaMethod::fromSignal(&ILXQtAbstractWMInterface::windowSnapshotChanged);
+    if (!isSignalConnected(coalescedSignal) && !isSignalConnected(snapshotSignal))
+        return;
+
+    int &props = m_pendingProperties[windowId];
+    if (props == 0)
+        m_pendingWindows.append(windowId);
+    props |= windowPropertyBit(LXQtTaskBarWindowProperty(prop));
+
+    if (!m_propertiesTimer->isActive())
+        m_propertiesTimer->start();
+}
 
+void ILXQtAbstractWMInterface::flushWindowProperties()
+{
+    QVector<WId> windows;
+    QHash<WId, int> properties;
+    windows.swap(m_pendingWindows);
+    properties.swap(m_pendingProperties);
+
+    for (const WId windowId : std::as_const(windows))
+        emitWindowProperties(windowId, properties.value(windowId));
+}
+
+void ILXQtAbstractWMInterface::emitWindowProperties(WId windowId, int props)
+{
+    emit windowPropertiesChanged(windowId, props);
+
+    static const QMetaMethod snapshotSignal = QMetaMethod::fromSignal(&ILXQtAbstractWMInterface::windowSnapshotChanged);
+    if (isSignalConnected(snapshotSignal))
+        emit windowSnapshotChanged(windowId, props, getWindowSnapshot(windowId));
+}
+
+void ILXQtAbstractWMInterface::announceWindowProperties(WId windowId, int props)
+{
+    // keep the listeners of the single properties informed, without queueing them again
+    m_announcing = true;
+    for (int prop = int(LXQtTaskBarWindowProperty::Title); prop <= int(LXQtTaskBarWindowProperty::Workspace); ++prop)
+    {
+        if (props & windowPropertyBit(LXQtTaskBarWindowProperty(prop)))
+            emit windowPropertyChanged(windowId, prop);
+    }
+    m_announcing = false;
+
+    if (int queued = m_pendingProperties.take(windowId))
+    {
+        m_pendingWindows.removeOne(windowId);
+        props |= queued;
+    }
+    emitWindowProperties(windowId, props);
+}
+
+LXQtTaskBarWindowSnapshot ILXQtAbstractWMInterface::getWindowSnapshot(WId windowId) const
+{
+    LXQtTaskBarWindowSnapshot snapshot;
+    snapshot.title = getWindowTitle(windowId);
+    snapshot.windowClass = getWindowClass(windowId);
+    snapshot.state = getWindowState(windowId);
+    snapshot.workspace = getWindowWorkspace(windowId);
+    snapshot.demandsAttention = applicationDemandsAttention(windowId);
+    return snapshot;
 }
 
 void ILXQtAbstractWMInterface::moveApplicationToPrevNextDesktop(WId windowId, bool next)
@@ -29,13 +29,16 @@
 #ifndef ILXQT_ABSTRACT_WM_INTERFACE_H
 #define ILXQT_ABSTRACT_WM_INTERFACE_H
 
+#include <QHash>
 #include <QObject>
+#include <QVector>
 
 #include "../lxqtpanelglobals.h"
 #include "lxqttaskbartypes.h"
 
 class QIcon;
 class QScreen;
+class QTimer;
 
 class LXQT_PANEL_API ILXQtAbstractWMInterface : public QObject
 {
@@ -46,6 +49,8 @@ public:
 
     // Backend
     virtual bool supportsAction(WId windowId, LXQtTaskBarBackendAction action) const = 0;
+    // All the supported actions of a window as a mask of backendActionBit()
+    virtual int getSupportedActions(WId windowId) const; // Default implementation
 
     // Windows
     virtual bool reloadWindows() = 0;
@@ -73,6 +78,8 @@ public:
 
     virtual WId getActiveWindow() const = 0;
 
+    virtual LXQtTaskBarWindowSnapshot getWindowSnapshot(WId windowId) const; // Default implementation
+
     // Workspaces
     // NOTE: indexes are 1-based, 0 means "Show on All desktops"
     virtual int getWorkspacesCount() const = 0;
@@ -117,6 +124,20 @@ signals:
     void windowAdded(WId windowId);
     void windowRemoved(WId windowId);
     void windowPropertyChanged(WId windowId, int prop);
+    /**
+     Coalesced form of windowPropertyChanged(): the changes of a window are
+     collected and emitted once per event loop pass, props being a mask of
+     windowPropertyBit(). Nothing is emitted for windows removed meanwhile.
+     Consumers which only read the current state of the window should use
+     it, so that a burst of changes causes their work once.
+     **/
+    void windowPropertiesChanged(WId windowId, int props);
+    /**
+     Emitted right after windowPropertiesChanged() with the values of the
+     window's properties, so that the listeners needn't query them one by one.
+     The snapshot is taken only while the signal is connected.
+     **/
+    void windowSnapshotChanged(WId windowId, int props, const LXQtTaskBarWindowSnapshot &snapshot);
 
     // Workspaces
     void workspacesCountChanged();
@@ -125,8 +146,43 @@ signals:
 
     // TODO: needed?
     void activeWindowChanged(WId windowId);
+
+protected:
+    /**
+     For backends which receive the changes of a window in atomic batches:
+     announces the whole batch at once, props being a mask of
+     windowPropertyBit(). windowPropertiesChanged() is emitted right away,
+     merged with the changes of the window queued so far.
+     **/
+    void announceWindowProperties(WId windowId, int props);
+
+private:
+    void queueWindowProperty(WId windowId, int prop);
+    void flushWindowProperties();
+    void emitWindowProperties(WId windowId, int props);
+
+    QTimer *m_propertiesTimer;
+    bool m_announcing = false;
+    QVector<WId> m_pendingWindows; //!< in the order of their first change
+    QHash<WId, int> m_pendingProperties;
 };
 
+/**
+ Backends declare where they can be used in their plugin metadata, so that
+ the panel can choose one without loading all of them:
+
+ Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0" FILE "mybackend.json")
+
+ {
+     "platforms": [ "wayland" ],
+     "environments": { "mydesktop": 100, "*": 10 }
+ }
+
+ "platforms" lists the Qt platform names the backend works with (no list
+ means any platform). "environments" maps XDG_CURRENT_DESKTOP entries to
+ scores, "*" matching any entry. Backends without "environments" are
+ loaded and asked with getBackendScore() instead.
+ **/
 class LXQT_PANEL_API ILXQtWMBackendLibrary
 {
 public:
@@ -113,6 +113,11 @@ WId LXQtDummyWMBackend::getActiveWindow() const
     return 0;
 }
 
+LXQtTaskBarWindowSnapshot LXQtDummyWMBackend::getWindowSnapshot(WId) const
+{
+    return LXQtTaskBarWindowSnapshot();
+}
+
 
 /************************************************
  *   Workspaces
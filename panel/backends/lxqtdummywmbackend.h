@@ -67,6 +67,8 @@ public:
 
     WId getActiveWindow() const override;
 
+    LXQtTaskBarWindowSnapshot getWindowSnapshot(WId windowId) const override;
+
     // Workspaces
     int getWorkspacesCount() const override;
     QString getWorkspaceName(int idx) const override;
@@ -29,7 +29,8 @@
 #ifndef LXQTTASKBARTYPES_H
 #define LXQTTASKBARTYPES_H
 
-#include <QtGlobal>
+#include <QRect>
+#include <QString>
 
 typedef quintptr WId;
 
@@ -49,6 +50,12 @@ enum class LXQtTaskBarBackendAction
     MoveToOutput
 };
 
+// The bit of an action in the masks of ILXQtAbstractWMInterface::getSupportedActions()
+constexpr int backendActionBit(LXQtTaskBarBackendAction action)
+{
+    return 1 << int(action);
+}
+
 enum class LXQtTaskBarWindowProperty
 {
     Title = 0,
@@ -60,6 +67,12 @@ enum class LXQtTaskBarWindowProperty
     Workspace
 };
 
+// The bit of a property in the masks of ILXQtAbstractWMInterface::windowPropertiesChanged()
+constexpr int windowPropertyBit(LXQtTaskBarWindowProperty prop)
+{
+    return 1 << int(prop);
+}
+
 enum class LXQtTaskBarWindowState
 {
     Hidden = 0,
@@ -79,4 +92,15 @@ enum class LXQtTaskBarWindowLayer
     KeepAbove
 };
 
+// The values of the properties of a window, as sent by ILXQtAbstractWMInterface::windowSnapshotChanged()
+struct LXQtTaskBarWindowSnapshot
+{
+    QString title;
+    QString windowClass;
+    LXQtTaskBarWindowState state = LXQtTaskBarWindowState::Normal;
+    int workspace = 0;
+    QRect geometry; // invalid if the backend doesn't know it
+    bool demandsAttention = false;
+};
+
 #endif // LXQTTASKBARTYPES_H
@@ -0,0 +1,527 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * LXQt - a lightweight, Qt based, desktop toolset
+ * https://lxqt.org
+ *
+ * Copyright: 2024 LXQt team
+ *
+ * This program or library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+
+#include "lxqtwmbackend_synthetic.h"
+
+#include <QColor>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPixmap>
+#include <QScreen>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+// Length of a step of the virtual clock in ms
+#define SYNTHETIC_TICK 5
+
+// Number of steps a window is dragged in one direction
+#define SYNTHETIC_DRAG_STEPS 30
+
+LXQtWMBackendSynthetic::LXQtWMBackendSynthetic(QObject *parent) :
+    ILXQtAbstractWMInterface(parent)
+{
+    loadScenario();
+    m_random.seed(m_scenario.seed);
+
+    if (QScreen *screen = QGuiApplication::primaryScreen())
+        m_screenGeometry = screen->geometry();
+    if (m_screenGeometry.isEmpty())
+        m_screenGeometry = QRect(0, 0, 1920, 1080);
+
+    m_windows.reserve(m_scenario.windows);
+    for (int i = 0; i < m_scenario.windows; ++i)
+        createWindow();
+    if (!m_windows.isEmpty())
+        m_activeWindow = m_windows.constLast();
+
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(SYNTHETIC_TICK);
+    connect(&m_timer, &QTimer::timeout, this, &LXQtWMBackendSynthetic::onTick);
+    QTimer::singleShot(m_scenario.startDelay, this, [this] { m_timer.start(); });
+}
+
+/************************************************
+ *   Scenario
+ ************************************************/
+void LXQtWMBackendSynthetic::loadScenario()
+{
+    const QString fileName = qEnvironmentVariable("LXQT_PANEL_SYNTHETIC_SCENARIO");
+    if (fileName.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Synthetic backend: can't read the scenario" << fileName << file.errorString();
+        return;
+    }
+
+    QJsonParseError error;
+    const QJsonObject obj = QJsonDocument::fromJson(file.readAll(), &error).object();
+    if (error.error != QJsonParseError::NoError)
+    {
+        qWarning() << "Synthetic backend: invalid scenario" << fileName << error.errorString();
+        return;
+    }
+
+    Scenario &s = m_scenario;
+    s.windows = std::max(0, obj.value(QLatin1String("windows")).toInt(s.windows));
+    s.classes = std::max(1, obj.value(QLatin1String("classes")).toInt(s.classes));
+    s.workspaces = std::max(1, obj.value(QLatin1String("workspaces")).toInt(s.workspaces));
+    s.seed = static_cast<quint32>(obj.value(QLatin1String("seed")).toInteger(s.seed));
+    s.startDelay = std::max(0, obj.value(QLatin1String("startDelay")).toInt(s.startDelay));
+    s.duration = std::max(0, obj.value(QLatin1String("duration")).toInt(s.duration));
+    s.titleRate = std::max(0.0, obj.value(QLatin1String("titleRate")).toDouble(s.titleRate));
+    s.geometryRate = std::max(0.0, obj.value(QLatin1String("geometryRate")).toDouble(s.geometryRate));
+    s.workspaceRate = std::max(0.0, obj.value(QLatin1String("workspaceRate")).toDouble(s.workspaceRate));
+    s.stateRate = std::max(0.0, obj.value(QLatin1String("stateRate")).toDouble(s.stateRate));
+    s.urgencyRate = std::max(0.0, obj.value(QLatin1String("urgencyRate")).toDouble(s.urgencyRate));
+    s.churnRate = std::max(0.0, obj.value(QLatin1String("churnRate")).toDouble(s.churnRate));
+}
+
+WId LXQtWMBackendSynthetic::createWindow()
+{
+    const WId windowId = m_nextWindowId++;
+
+    WindowData data;
+    data.classIndex = static_cast<int>(windowId % m_scenario.classes);
+    data.workspace = static_cast<int>(windowId % m_scenario.workspaces) + 1;
+    data.title = QStringLiteral("Synthetic window %1").arg(windowId);
+
+    const int width = m_random.bounded(200, 600);
+    const int height = m_random.bounded(150, 450);
+    const int x = m_screenGeometry.x() + m_random.bounded(std::max(1, m_screenGeometry.width() - width));
+    const int y = m_screenGeometry.y() + m_random.bounded(std::max(1, m_screenGeometry.height() - height));
+    data.geometry = QRect(x, y, width, height);
+
+    m_windowData.insert(windowId, data);
+    m_windows.append(windowId);
+    return windowId;
+}
+
+void LXQtWMBackendSynthetic::removeWindow(WId windowId)
+{
+    if (!m_windowData.remove(windowId))
+        return;
+
+    m_windows.removeOne(windowId);
+    if (m_dragWindow == windowId)
+        m_dragSteps = 0;
+
+    emit windowRemoved(windowId);
+
+    if (m_activeWindow == windowId)
+    {
+        m_activeWindow = 0;
+        emit activeWindowChanged(m_activeWindow);
+    }
+}
+
+WId LXQtWMBackendSynthetic::randomWindow()
+{
+    if (m_windows.isEmpty())
+        return 0;
+    return m_windows.at(m_random.bounded(static_cast<int>(m_windows.size())));
+}
+
+int LXQtWMBackendSynthetic::eventsDue(double rate) const
+{
+    // Events between the start of this tick and the start of the next one
+    const double start = rate * m_tick * SYNTHETIC_TICK / 1000;
+    const double end = rate * (m_tick + 1) * SYNTHETIC_TICK / 1000;
+    return static_cast<int>(std::floor(end) - std::floor(start));
+}
+
+void LXQtWMBackendSynthetic::changeTitle()
+{
+    const WId windowId = randomWindow();
+    if (!windowId)
+        return;
+
+    WindowData &data = m_windowData[windowId];
+    data.title = QStringLiteral("Synthetic window %1 - %2").arg(windowId).arg(++data.titleCounter);
+    emit windowPropertyChanged(windowId, int(LXQtTaskBarWindowProperty::Title));
+}
+
+void LXQtWMBackendSynthetic::dragStep()
+{
+    if (m_dragSteps <= 0 || !m_windowData.contains(m_dragWindow))
+    {
+        m_dragWindow = randomWindow();
+        if (!m_dragWindow)
+            return;
+        m_dragSteps = SYNTHETIC_DRAG_STEPS;
+        m_dragDelta = QPoint(m_random.bounded(-8, 9), m_random.bounded(-8, 9));
+    }
+
+    --m_dragSteps;
+    WindowData &data = m_windowData[m_dragWindow];
+    QRect geometry = data.geometry.translated(m_dragDelta);
+    // keep at least a part of the window on the screen
+    if (!geometry.intersects(m_screenGeometry))
+        geometry = data.geometry.translated(-m_dragDelta);
+    data.geometry = geometry;
+    emit windowPropertyChanged(m_dragWindow, int(LXQtTaskBarWindowProperty::Geometry));
+}
+
+void LXQtWMBackendSynthetic::onTick()
+{
+    if (m_scenario.duration > 0 && m_tick * SYNTHETIC_TICK >= m_scenario.duration)
+    {
+        m_timer.stop();
+        return;
+    }
+
+    for (int i = eventsDue(m_scenario.titleRate); i > 0; --i)
+        changeTitle();
+
+    for (int i = eventsDue(m_scenario.geometryRate); i > 0; --i)
+        dragStep();
+
+    for (int i = eventsDue(m_scenario.workspaceRate); i > 0; --i)
+        setCurrentWorkspace(m_currentWorkspace % m_scenario.workspaces + 1);
+
+    for (int i = eventsDue(m_scenario.stateRate); i > 0; --i)
+    {
+        const WId windowId = randomWindow();
+        if (!windowId)
+            break;
+        const bool minimized = m_windowData.value(windowId).state == LXQtTaskBarWindowState::Minimized;
+        setWindowState(windowId, LXQtTaskBarWindowState::Minimized, !minimized);
+    }
+
+    for (int i = eventsDue(m_scenario.urgencyRate); i > 0; --i)
+    {
+        const WId windowId = randomWindow();
+        if (!windowId)
+            break;
+        WindowData &data = m_windowData[windowId];
+        data.urgent = !data.urgent;
+        emit windowPropertyChanged(windowId, int(LXQtTaskBarWindowProperty::Urgency));
+    }
+
+    for (int i = eventsDue(m_scenario.churnRate); i > 0; --i)
+    {
+        // keep the number of windows around the initial one
+        if (m_windows.size() >= m_scenario.windows && !m_windows.isEmpty())
+            removeWindow(randomWindow());
+        else
+            emit windowAdded(createWindow());
+    }
+
+    ++m_tick;
+}
+
+/************************************************
+ *   Windows function
+ ************************************************/
+bool LXQtWMBackendSynthetic::supportsAction(WId windowId, LXQtTaskBarBackendAction action) const
+{
+    if (!m_windowData.contains(windowId))
+        return false;
+
+    // There is a single (virtual) output
+    return action != LXQtTaskBarBackendAction::MoveToOutput;
+}
+
+bool LXQtWMBackendSynthetic::reloadWindows()
+{
+    // The windows exist only here, so nothing can be out of date
+    emit reloaded();
+    return true;
+}
+
+QVector<WId> LXQtWMBackendSynthetic::getCurrentWindows() const
+{
+    return m_windows;
+}
+
+QString LXQtWMBackendSynthetic::getWindowTitle(WId windowId) const
+{
+    return m_windowData.value(windowId).title;
+}
+
+bool LXQtWMBackendSynthetic::applicationDemandsAttention(WId windowId) const
+{
+    return m_windowData.value(windowId).urgent;
+}
+
+QIcon LXQtWMBackendSynthetic::getApplicationIcon(WId windowId, int devicePixels) const
+{
+    auto it = m_windowData.constFind(windowId);
+    if (it == m_windowData.cend())
+        return QIcon();
+
+    QIcon &icon = m_icons[it->classIndex];
+    if (icon.isNull())
+    {
+        QPixmap pixmap(std::max(devicePixels, 16), std::max(devicePixels, 16));
+        pixmap.fill(QColor::fromHsv(it->classIndex * 360 / m_scenario.classes, 200, 220));
+        icon = QIcon(pixmap);
+    }
+    return icon;
+}
+
+QString LXQtWMBackendSynthetic::getWindowClass(WId windowId) const
+{
+    auto it = m_windowData.constFind(windowId);
+    if (it == m_windowData.cend())
+        return QString();
+    return QStringLiteral("synthetic-app-%1").arg(it->classIndex + 1);
+}
+
+LXQtTaskBarWindowLayer LXQtWMBackendSynthetic::getWindowLayer(WId windowId) const
+{
+    return m_windowData.value(windowId).layer;
+}
+
+bool LXQtWMBackendSynthetic::setWindowLayer(WId windowId, LXQtTaskBarWindowLayer layer)
+{
+    auto it = m_windowData.find(windowId);
+    if (it == m_windowData.end())
+        return false;
+
+    it->layer = layer;
+    return true;
+}
+
+LXQtTaskBarWindowState LXQtWMBackendSynthetic::getWindowState(WId windowId) const
+{
+    return m_windowData.value(windowId).state;
+}
+
+bool LXQtWMBackendSynthetic::setWindowState(WId windowId, LXQtTaskBarWindowState state, bool set)
+{
+    auto it = m_windowData.find(windowId);
+    if (it == m_windowData.end())
+        return false;
+
+    const LXQtTaskBarWindowState newState = set ? state : LXQtTaskBarWindowState::Normal;
+    if (it->state == newState)
+        return true;
+
+    it->state = newState;
+    emit windowPropertyChanged(windowId, int(LXQtTaskBarWindowProperty::State));
+
+    if (newState == LXQtTaskBarWindowState::Minimized && m_activeWindow == windowId)
+    {
+        m_activeWindow = 0;
+        emit activeWindowChanged(m_activeWindow);
+    }
+    return true;
+}
+
+bool LXQtWMBackendSynthetic::isWindowActive(WId windowId) const
+{
+    return m_activeWindow == windowId && windowId != 0;
+}
+
+bool LXQtWMBackendSynthetic::raiseWindow(WId windowId, bool onCurrentWorkSpace)
+{
+    auto it = m_windowData.find(windowId);
+    if (it == m_windowData.end())
+        return false;
+
+    if (onCurrentWorkSpace && it->workspace != onAllWorkspacesEnum())
+        setWindowOnWorkspace(windowId, m_currentWorkspace);
+    else if (it->workspace != onAllWorkspacesEnum())
+        setCurrentWorkspace(it->workspace);
+
+    if (it->state == LXQtTaskBarWindowState::Minimized)
+        setWindowState(windowId, LXQtTaskBarWindowState::Normal, true);
+
+    if (m_activeWindow != windowId)
+    {
+        m_activeWindow = windowId;
+        emit activeWindowChanged(m_activeWindow);
+    }
+    return true;
+}
+
+bool LXQtWMBackendSynthetic::closeWindow(WId windowId)
+{
+    if (!m_windowData.contains(windowId))
+        return false;
+
+    removeWindow(windowId);
+    return true;
+}
+
+WId LXQtWMBackendSynthetic::getActiveWindow() const
+{
+    return m_activeWindow;
+}
+
+LXQtTaskBarWindowSnapshot LXQtWMBackendSynthetic::getWindowSnapshot(WId windowId) const
+{
+    LXQtTaskBarWindowSnapshot snapshot;
+    auto it = m_windowData.constFind(windowId);
+    if (it == m_windowData.cend())
+        return snapshot;
+
+    snapshot.title = it->title;
+    snapshot.windowClass = getWindowClass(windowId);
+    snapshot.state = it->state;
+    snapshot.workspace = it->workspace;
+    snapshot.geometry = it->geometry;
+    snapshot.demandsAttention = it->urgent;
+    return snapshot;
+}
+
+/************************************************
+ *   Workspaces
+ ************************************************/
+int LXQtWMBackendSynthetic::getWorkspacesCount() const
+{
+    return m_scenario.workspaces;
+}
+
+QString LXQtWMBackendSynthetic::getWorkspaceName(int idx) const
+{
+    return QStringLiteral("Desktop %1").arg(idx);
+}
+
+int LXQtWMBackendSynthetic::getCurrentWorkspace() const
+{
+    return m_currentWorkspace;
+}
+
+bool LXQtWMBackendSynthetic::setCurrentWorkspace(int idx)
+{
+    if (idx < 1 || idx > m_scenario.workspaces)
+        return false;
+
+    if (m_currentWorkspace != idx)
+    {
+        m_currentWorkspace = idx;
+        emit currentWorkspaceChanged(m_currentWorkspace);
+    }
+    return true;
+}
+
+int LXQtWMBackendSynthetic::getWindowWorkspace(WId windowId) const
+{
+    return m_windowData.value(windowId).workspace;
+}
+
+bool LXQtWMBackendSynthetic::setWindowOnWorkspace(WId windowId, int idx)
+{
+    auto it = m_windowData.find(windowId);
+    if (it == m_windowData.end() || idx < onAllWorkspacesEnum() || idx > m_scenario.workspaces)
+        return false;
+
+    if (it->workspace != idx)
+    {
+        it->workspace = idx;
+        emit windowPropertyChanged(windowId, int(LXQtTaskBarWindowProperty::Workspace));
+    }
+    return true;
+}
+
+void LXQtWMBackendSynthetic::moveApplicationToPrevNextMonitor(WId windowId, bool next, bool raiseOnCurrentDesktop)
+{
+    Q_UNUSED(windowId)
+    Q_UNUSED(next)
+    Q_UNUSED(raiseOnCurrentDesktop)
+}
+
+bool LXQtWMBackendSynthetic::isWindowOnScreen(QScreen *screen, WId windowId) const
+{
+    if (!screen)
+        return false;
+    return screen->geometry().intersects(m_windowData.value(windowId).geometry);
+}
+
+bool LXQtWMBackendSynthetic::setDesktopLayout(Qt::Orientation orientation, int rows, int columns, bool rightToLeft)
+{
+    Q_UNUSED(orientation)
+    Q_UNUSED(rows)
+    Q_UNUSED(columns)
+    Q_UNUSED(rightToLeft)
+    return false;
+}
+
+/************************************************
+ *   X11 Specific
+ ************************************************/
+void LXQtWMBackendSynthetic::moveApplication(WId windowId)
+{
+    Q_UNUSED(windowId)
+}
+
+void LXQtWMBackendSynthetic::resizeApplication(WId windowId)
+{
+    Q_UNUSED(windowId)
+}
+
+void LXQtWMBackendSynthetic::refreshIconGeometry(WId windowId, const QRect &geom)
+{
+    Q_UNUSED(windowId)
+    Q_UNUSED(geom)
+}
+
+bool LXQtWMBackendSynthetic::isAreaOverlapped(const QRect &area) const
+{
+    if (m_showingDesktop)
+        return false;
+
+    for (auto it = m_windowData.cbegin(), it_end = m_windowData.cend(); it != it_end; ++it)
+    {
+        if (it->workspace != m_currentWorkspace && it->workspace != onAllWorkspacesEnum())
+            continue;
+        if (it->state == LXQtTaskBarWindowState::Minimized || it->state == LXQtTaskBarWindowState::Hidden)
+            continue;
+        if (it->geometry.intersects(area))
+            return true;
+    }
+    return false;
+}
+
+bool LXQtWMBackendSynthetic::isShowingDesktop() const
+{
+    return m_showingDesktop;
+}
+
+bool LXQtWMBackendSynthetic::showDesktop(bool value)
+{
+    m_showingDesktop = value;
+    return true;
+}
+
+int LXQtWMBackendSyntheticLibrary::getBackendScore(const QString &key) const
+{
+    // Never chosen for a real desktop
+    return key == QLatin1String("lxqt-panel-synthetic") ? 1000 : 0;
+}
+
+ILXQtAbstractWMInterface *LXQtWMBackendSyntheticLibrary::instance() const
+{
+    return new LXQtWMBackendSynthetic;
+}
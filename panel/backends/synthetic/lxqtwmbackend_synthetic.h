@@ -0,0 +1,205 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * LXQt - a lightweight, Qt based, desktop toolset
+ * https://lxqt.org
+ *
+ * Copyright: 2024 LXQt team
+ *
+ * This program or library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+
+#ifndef LXQT_WM_BACKEND_SYNTHETIC_H
+#define LXQT_WM_BACKEND_SYNTHETIC_H
+
+#include "../ilxqtabstractwmiface.h"
+
+#include <QHash>
+#include <QIcon>
+#include <QRandomGenerator>
+#include <QRect>
+#include <QTimer>
+
+/**
+ The synthetic backend fabricates windows and workspaces and changes them
+ at fixed rates, so that the taskbar, the desktop switcher and the panel
+ hiding can be put under a reproducible load without a window manager.
+
+ It is chosen for the "lxqt-panel-synthetic" desktop outside of X11
+ sessions, e.g. by running XDG_CURRENT_DESKTOP=lxqt-panel-synthetic
+ lxqt-panel, or with "<desktop>:synthetic" in preferred_backend.
+
+ The scenario is read from the JSON file named by the
+ LXQT_PANEL_SYNTHETIC_SCENARIO environment variable. All keys are optional:
+
+ {
+     "windows": 2000,       // initial number of windows
+     "classes": 20,         // windows are spread evenly over these classes
+     "workspaces": 4,
+     "seed": 1,             // the same seed gives the same sequence of events
+     "startDelay": 1000,    // ms before the first change
+     "duration": 0,         // ms of changes, 0 means no end
+     "titleRate": 200,      // title changes per second
+     "geometryRate": 60,    // steps of window drags per second
+     "workspaceRate": 2,    // workspace switches per second
+     "stateRate": 0,        // minimize/restore toggles per second
+     "urgencyRate": 0,      // urgency toggles per second
+     "churnRate": 0         // windows opened or closed per second
+ }
+
+ The rates are counted on a virtual clock advanced by every timer tick, so
+ a run produces the same events in the same order even on a slow machine.
+ **/
+class LXQtWMBackendSynthetic : public ILXQtAbstractWMInterface
+{
+    Q_OBJECT
+
+public:
+    explicit LXQtWMBackendSynthetic(QObject *parent = nullptr);
+
+    // Backend
+    virtual bool supportsAction(WId windowId, LXQtTaskBarBackendAction action) const override;
+
+    // Windows
+    virtual bool reloadWindows() override;
+
+    virtual QVector<WId> getCurrentWindows() const override;
+    virtual QString getWindowTitle(WId windowId) const override;
+    virtual bool applicationDemandsAttention(WId windowId) const override;
+    virtual QIcon getApplicationIcon(WId windowId, int devicePixels) const override;
+    virtual QString getWindowClass(WId windowId) const override;
+
+    virtual LXQtTaskBarWindowLayer getWindowLayer(WId windowId) const override;
+    virtual bool setWindowLayer(WId windowId, LXQtTaskBarWindowLayer layer) override;
+
+    virtual LXQtTaskBarWindowState getWindowState(WId windowId) const override;
+    virtual bool setWindowState(WId windowId, LXQtTaskBarWindowState state, bool set) override;
+
+    virtual bool isWindowActive(WId windowId) const override;
+    virtual bool raiseWindow(WId windowId, bool onCurrentWorkSpace) override;
+
+    virtual bool closeWindow(WId windowId) override;
+
+    virtual WId getActiveWindow() const override;
+
+    virtual LXQtTaskBarWindowSnapshot getWindowSnapshot(WId windowId) const override;
+
+    // Workspaces
+    virtual int getWorkspacesCount() const override;
+    virtual QString getWorkspaceName(int idx) const override;
+
+    virtual int getCurrentWorkspace() const override;
+    virtual bool setCurrentWorkspace(int idx) override;
+
+    virtual int getWindowWorkspace(WId windowId) const override;
+    virtual bool setWindowOnWorkspace(WId windowId, int idx) override;
+
+    virtual void moveApplicationToPrevNextMonitor(WId windowId, bool next, bool raiseOnCurrentDesktop) override;
+
+    virtual bool isWindowOnScreen(QScreen *screen, WId windowId) const override;
+
+    virtual bool setDesktopLayout(Qt::Orientation orientation, int rows, int columns, bool rightToLeft) override;
+
+    // X11 Specific
+    virtual void moveApplication(WId windowId) override;
+    virtual void resizeApplication(WId windowId) override;
+
+    virtual void refreshIconGeometry(WId windowId, const QRect &geom) override;
+
+    // Panel internal
+    virtual bool isAreaOverlapped(const QRect& area) const override;
+
+    // Show Destop
+    virtual bool isShowingDesktop() const override;
+    virtual bool showDesktop(bool value) override;
+
+private slots:
+    void onTick();
+
+private:
+    struct Scenario
+    {
+        int windows = 2000;
+        int classes = 20;
+        int workspaces = 4;
+        quint32 seed = 1;
+        int startDelay = 1000;
+        int duration = 0;
+        double titleRate = 200;
+        double geometryRate = 60;
+        double workspaceRate = 2;
+        double stateRate = 0;
+        double urgencyRate = 0;
+        double churnRate = 0;
+    };
+
+    struct WindowData
+    {
+        int classIndex = 0;
+        quint64 titleCounter = 0;
+        QString title;
+        QRect geometry;
+        int workspace = 1;
+        LXQtTaskBarWindowState state = LXQtTaskBarWindowState::Normal;
+        LXQtTaskBarWindowLayer layer = LXQtTaskBarWindowLayer::Normal;
+        bool urgent = false;
+    };
+
+    void loadScenario();
+    WId createWindow();
+    void removeWindow(WId windowId);
+    WId randomWindow();
+    int eventsDue(double rate) const;
+
+    void changeTitle();
+    void dragStep();
+
+    Scenario m_scenario;
+    QRandomGenerator m_random;
+    QTimer m_timer;
+    qint64 m_tick = 0;
+
+    QRect m_screenGeometry;
+    QVector<WId> m_windows;
+    QHash<WId, WindowData> m_windowData;
+    WId m_nextWindowId = 1;
+    WId m_activeWindow = 0;
+    int m_currentWorkspace = 1;
+    bool m_showingDesktop = false;
+
+    WId m_dragWindow = 0;
+    int m_dragSteps = 0;
+    QPoint m_dragDelta;
+
+    // one icon per class, like real applications
+    mutable QHash<int, QIcon> m_icons;
+};
+
+
+class LXQtWMBackendSyntheticLibrary: public QObject, public ILXQtWMBackendLibrary
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0" FILE "lxqtwmbackend_synthetic.json")
+    Q_INTERFACES(ILXQtWMBackendLibrary)
+public:
+    int getBackendScore(const QString& key) const override;
+
+    ILXQtAbstractWMInterface* instance() const override;
+};
+
+#endif // LXQT_WM_BACKEND_SYNTHETIC_H
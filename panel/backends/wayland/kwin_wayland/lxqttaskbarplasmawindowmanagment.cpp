@@ -8,7 +8,11 @@
 
 #include "lxqttaskbarplasmawindowmanagment.h"
 
+#include <QCache>
+#include <QCryptographicHash>
 #include <QFuture>
+#include <QMutex>
+#include <QThreadPool>
 #include <QtConcurrent>
 #include <QGuiApplication>
 #include <QMimeData>
@@ -22,6 +26,107 @@
 #include <sys/poll.h>
 #include <unistd.h>
 
+/*
+ * LXQtTaskBarPlasmaIconFetcher
+ *
+ * Reads the icons sent by the compositor on a small pool of its own, so that
+ * many windows appearing at once (e.g. on session restore) don't flood the
+ * global thread pool. A request superseded by a newer one of the same window
+ * is dropped without reading, and identical icon data (e.g. of the windows of
+ * one application) is decoded once.
+ */
+
+namespace {
+
+constexpr int iconFetchThreads = 2;
+constexpr int iconCacheSize = 64; // decoded icons
+
+class LXQtTaskBarPlasmaIconFetcher
+{
+public:
+    static LXQtTaskBarPlasmaIconFetcher *instance()
+    {
+        static LXQtTaskBarPlasmaIconFetcher fetcher;
+        return &fetcher;
+    }
+
+    // Reads the icon from fd (and closes it), unless serial isn't the latest request anymore.
+    QFuture<QIcon> fetch(const QString &uuid, int fd, std::shared_ptr<std::atomic<quint64>> latest, quint64 serial)
+    {
+        return QtConcurrent::run(&m_pool, [this, uuid, fd, latest, serial] {
+            auto closeGuard = qScopeGuard([fd]() {
+                ::close(fd);
+            });
+            if (latest->load() != serial) {
+                return QIcon();
+            }
+
+            const QByteArray data = readIconData(uuid, fd);
+            if (data.isEmpty() || latest->load() != serial) {
+                return QIcon();
+            }
+
+            const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+            {
+                QMutexLocker locker(&m_mutex);
+                if (const QIcon *cached = m_icons.object(hash)) {
+                    return *cached;
+                }
+            }
+
+            QIcon icon;
+            QDataStream ds(data);
+            ds >> icon;
+
+            QMutexLocker locker(&m_mutex);
+            m_icons.insert(hash, new QIcon(icon));
+            return icon;
+        });
+    }
+
+private:
+    LXQtTaskBarPlasmaIconFetcher()
+        : m_icons(iconCacheSize)
+    {
+        m_pool.setMaxThreadCount(iconFetchThreads);
+    }
+
+    static QByteArray readIconData(const QString &uuid, int fd)
+    {
+        pollfd pollFd;
+        pollFd.fd = fd;
+        pollFd.events = POLLIN;
+        QByteArray data;
+        while (true) {
+            int ready = poll(&pollFd, 1, 1000);
+            if (ready < 0 && errno != EINTR) {
+                qWarning() << "TaskManager: polling for icon of window" << uuid << "failed";
+                return QByteArray();
+            } else if (ready == 0) {
+                qWarning() << "TaskManager: time out polling for icon of window" << uuid;
+                return QByteArray();
+            } else {
+                char buffer[4096];
+                int n = read(fd, buffer, sizeof(buffer));
+                if (n < 0) {
+                    qWarning() << "TaskManager: error reading icon of window" << uuid;
+                    return QByteArray();
+                } else if (n > 0) {
+                    data.append(buffer, n);
+                } else {
+                    return data;
+                }
+            }
+        }
+    }
+
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    QCache<QByteArray, QIcon> m_icons;
+};
+
+}
+
 /*
  * LXQtTaskBarPlasmaWindow
  */
@@ -68,43 +173,16 @@ void LXQtTaskBarPlasmaWindow::org_kde_plasma_window_icon_changed()
     }
     get_icon(pipeFds[1]);
     ::close(pipeFds[1]);
-    auto readIcon = [uuid = uuid](int fd) {
-        auto closeGuard = qScopeGuard([fd]() {
-            ::close(fd);
-        });
-        pollfd pollFd;
-        pollFd.fd = fd;
-        pollFd.events = POLLIN;
-        QByteArray data;
-        while (true) {
-            int ready = poll(&pollFd, 1, 1000);
-            if (ready < 0 && errno != EINTR) {
-                qWarning() << "TaskManager: polling for icon of window" << uuid << "failed";
-                return QIcon();
-            } else if (ready == 0) {
-                qWarning() << "TaskManager: time out polling for icon of window" << uuid;
-                return QIcon();
-            } else {
-                char buffer[4096];
-                int n = read(fd, buffer, sizeof(buffer));
-                if (n < 0) {
-                    qWarning() << "TaskManager: error reading icon of window" << uuid;
-                    return QIcon();
-                } else if (n > 0) {
-                    data.append(buffer, n);
-                } else {
-                    QIcon icon;
-                    QDataStream ds(data);
-                    ds >> icon;
-                    return icon;
-                }
-            }
-        }
-    };
-    QFuture<QIcon> future = QtConcurrent::run(readIcon, pipeFds[0]);
+
+    // latest wins: the result of an older request is ignored
+    const quint64 serial = ++*iconRequest;
+    QFuture<QIcon> future = LXQtTaskBarPlasmaIconFetcher::instance()->fetch(uuid, pipeFds[0], iconRequest, serial);
     auto watcher = new QFutureWatcher<QIcon>();
     watcher->setFuture(future);
-    connect(watcher, &QFutureWatcher<QIcon>::finished, this, [this, watcher] {
+    connect(watcher, &QFutureWatcher<QIcon>::finished, this, [this, watcher, serial] {
+        if (iconRequest->load() != serial) {
+            return;
+        }
         icon = watcher->future().result();
         Q_EMIT iconChanged();
     });
@@ -113,6 +191,7 @@ void LXQtTaskBarPlasmaWindow::org_kde_plasma_window_icon_changed()
 
 void LXQtTaskBarPlasmaWindow::org_kde_plasma_window_themed_icon_name_changed(const QString &name)
 {
+    ++*iconRequest; // supersedes a pending fetch
     icon = QIcon::fromTheme(name);
     Q_EMIT iconChanged();
 }
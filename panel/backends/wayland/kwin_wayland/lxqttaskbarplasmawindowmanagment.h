@@ -13,6 +13,9 @@
 #include <QPointer>
 #include <QtWaylandClient/QWaylandClientExtensionTemplate>
 
+#include <atomic>
+#include <memory>
+
 #include "qwayland-plasma-window-management.h"
 
 typedef quintptr WId;
@@ -102,6 +105,8 @@ private:
     void setParentWindow(LXQtTaskBarPlasmaWindow *parent);
 
     QMetaObject::Connection parentWindowUnmappedConnection;
+    // serial of the latest icon request, shared with the fetching thread
+    std::shared_ptr<std::atomic<quint64>> iconRequest = std::make_shared<std::atomic<quint64>>(0);
 };
 
 class LXQtTaskBarPlasmaWindowManagment : public QWaylandClientExtensionTemplate<LXQtTaskBarPlasmaWindowManagment>,
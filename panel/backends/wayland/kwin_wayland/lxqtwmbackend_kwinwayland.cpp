@@ -35,19 +35,13 @@
 #include <QScreen>
 #include <QGuiApplication>
 
+#include <algorithm>
+
 auto findWindow(const std::vector<std::unique_ptr<LXQtTaskBarPlasmaWindow>>& windows, LXQtTaskBarPlasmaWindow *window)
 {
-    //TODO: use algorithms
-    auto end = windows.end();
-    for(auto it = windows.begin(); it != end; it++)
-    {
-        if((*it).get() == window)
-        {
-            return it;
-        }
-    }
-
-    return windows.end();
+    return std::find_if(windows.begin(), windows.end(), [window] (const std::unique_ptr<LXQtTaskBarPlasmaWindow> &w) {
+        return w.get() == window;
+    });
 }
 
 LXQtWMBackend_KWinWayland::LXQtWMBackend_KWinWayland(QObject *parent) :
@@ -372,6 +366,22 @@ WId LXQtWMBackend_KWinWayland::getActiveWindow() const
     return 0;
 }
 
+LXQtTaskBarWindowSnapshot LXQtWMBackend_KWinWayland::getWindowSnapshot(WId windowId) const
+{
+    LXQtTaskBarWindowSnapshot snapshot;
+    LXQtTaskBarPlasmaWindow *window = getWindow(windowId);
+    if(!window)
+        return snapshot;
+
+    snapshot.title = window->title;
+    snapshot.windowClass = window->appId;
+    snapshot.state = getWindowState(windowId);
+    snapshot.workspace = getWindowWorkspace(windowId);
+    snapshot.geometry = window->geometry;
+    snapshot.demandsAttention = applicationDemandsAttention(windowId);
+    return snapshot;
+}
+
 int LXQtWMBackend_KWinWayland::getWorkspacesCount() const
 {
     return m_workspaceInfo->numberOfDesktops();
@@ -536,7 +546,7 @@ bool LXQtWMBackend_KWinWayland::showDesktop(bool value)
 
 void LXQtWMBackend_KWinWayland::addWindow(LXQtTaskBarPlasmaWindow *window)
 {
-    if (findWindow(windows, window) != windows.end() || transients.contains(window))
+    if (windowIndex.contains(window->getWindowId()) || transients.contains(window))
     {
         return;
     }
@@ -548,7 +558,7 @@ void LXQtWMBackend_KWinWayland::addWindow(LXQtTaskBarPlasmaWindow *window)
         {
             if(window->acceptedInTaskBar)
                 emit windowRemoved(window->getWindowId());
-            windows.erase(it);
+            eraseWindow(it);
             transientsDemandingAttention.remove(window);
             lastActivated.remove(window);
         }
@@ -663,9 +673,9 @@ void LXQtWMBackend_KWinWayland::addWindow(LXQtTaskBarPlasmaWindow *window)
             else
             {
                 // lost a leader, add to regular windows list.
-                Q_ASSERT(findWindow(windows, window) == windows.end());
+                Q_ASSERT(!windowIndex.contains(window->getWindowId()));
 
-                windows.emplace_back(window);
+                insertWindow(window);
             }
         }
         else if (leader)
@@ -674,7 +684,7 @@ void LXQtWMBackend_KWinWayland::addWindow(LXQtTaskBarPlasmaWindow *window)
             auto it = findWindow(windows, window);
             Q_ASSERT(it != windows.end());
 
-            windows.erase(it);
+            eraseWindow(it);
             lastActivated.remove(window);
         }
     });
@@ -755,11 +765,23 @@ void LXQtWMBackend_KWinWayland::addWindow(LXQtTaskBarPlasmaWindow *window)
     }
     else
     {
-        windows.emplace_back(window);
+        insertWindow(window);
         updateWindowAcceptance(window);
     }
 }
 
+void LXQtWMBackend_KWinWayland::insertWindow(LXQtTaskBarPlasmaWindow *window)
+{
+    windows.emplace_back(window);
+    windowIndex.insert(window->getWindowId(), window);
+}
+
+void LXQtWMBackend_KWinWayland::eraseWindow(std::vector<std::unique_ptr<LXQtTaskBarPlasmaWindow>>::const_iterator it)
+{
+    windowIndex.remove((*it)->getWindowId());
+    windows.erase(it);
+}
+
 bool LXQtWMBackend_KWinWayland::acceptWindow(LXQtTaskBarPlasmaWindow *window) const
 {
     if(window->windowState.testFlag(LXQtTaskBarPlasmaWindow::state::state_skiptaskbar))
@@ -787,13 +809,7 @@ void LXQtWMBackend_KWinWayland::updateWindowAcceptance(LXQtTaskBarPlasmaWindow *
 
 LXQtTaskBarPlasmaWindow *LXQtWMBackend_KWinWayland::getWindow(WId windowId) const
 {
-    for(auto &window : std::as_const(windows))
-    {
-        if(window->getWindowId() == windowId)
-            return window.get();
-    }
-
-    return nullptr;
+    return windowIndex.value(windowId, nullptr);
 }
 
 int LXQtWMBackendKWinWaylandLibrary::getBackendScore(const QString &key) const
@@ -71,6 +71,8 @@ public:
 
     virtual WId getActiveWindow() const override;
 
+    virtual LXQtTaskBarWindowSnapshot getWindowSnapshot(WId windowId) const override;
+
     // Workspaces
     virtual int getWorkspacesCount() const override;
     virtual QString getWorkspaceName(int idx) const override;
@@ -105,6 +107,10 @@ private:
     bool acceptWindow(LXQtTaskBarPlasmaWindow *window) const;
     void updateWindowAcceptance(LXQtTaskBarPlasmaWindow *window);
 
+    // keep windows and windowIndex in sync
+    void insertWindow(LXQtTaskBarPlasmaWindow *window);
+    void eraseWindow(std::vector<std::unique_ptr<LXQtTaskBarPlasmaWindow>>::const_iterator it);
+
 private:
     LXQtTaskBarPlasmaWindow *getWindow(WId windowId) const;
 
@@ -115,6 +121,8 @@ private:
     QHash<LXQtTaskBarPlasmaWindow *, QTime> lastActivated;
     LXQtTaskBarPlasmaWindow *activeWindow = nullptr;
     std::vector<std::unique_ptr<LXQtTaskBarPlasmaWindow>> windows;
+    // index of windows by id, for getWindow()
+    QHash<WId, LXQtTaskBarPlasmaWindow *> windowIndex;
     // key=transient child, value=leader
     QHash<LXQtTaskBarPlasmaWindow *, LXQtTaskBarPlasmaWindow *> transients;
     // key=leader, values=transient children
@@ -124,7 +132,7 @@ private:
 class LXQtWMBackendKWinWaylandLibrary: public QObject, public ILXQtWMBackendLibrary
 {
     Q_OBJECT
-    Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0")
+    Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0" FILE "lxqtwmbackend_kwinwayland.json")
     Q_INTERFACES(ILXQtWMBackendLibrary)
 public:
     int getBackendScore(const QString& key) const override;
@@ -503,6 +503,7 @@ void LXQtTaskbarWlrootsWindow::zwlr_foreign_toplevel_handle_v1_done()
             emit activatedChanged();
 
         emit stateChanged();
+        emit done();
     }
 
     /** 4. Clear m+m_pendingState.<variable>Changed flags */
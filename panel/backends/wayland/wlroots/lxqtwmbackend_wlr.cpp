@@ -236,6 +236,21 @@ WId LXQtTaskbarWlrootsBackend::getActiveWindow() const
     return activeWindow;
 }
 
+LXQtTaskBarWindowSnapshot LXQtTaskbarWlrootsBackend::getWindowSnapshot(WId windowId) const
+{
+    LXQtTaskBarWindowSnapshot snapshot;
+    LXQtTaskbarWlrootsWindow *window = getWindow(windowId);
+    if(!window)
+        return snapshot;
+
+    // the protocol tells neither the geometry nor the urgency
+    snapshot.title = window->windowState.title;
+    snapshot.windowClass = window->windowState.appId;
+    snapshot.state = getWindowState(windowId);
+    snapshot.workspace = getWindowWorkspace(windowId);
+    return snapshot;
+}
+
 int LXQtTaskbarWlrootsBackend::getWorkspacesCount() const
 {
     return 1;
@@ -309,60 +324,62 @@ bool LXQtTaskbarWlrootsBackend::showDesktop(bool)
     return false;
 }
 
+WId LXQtTaskbarWlrootsBackend::findKnownWindow(WId tgt) const
+{
+    // either a window or a transient with the same handle
+    if (LXQtTaskbarWlrootsWindow *window = getWindow(tgt)) {
+        return handles.value(window->ID, 0);
+    }
+    return 0;
+}
+
 WId LXQtTaskbarWlrootsBackend::findWindow(WId tgt) const
 {
-    for (auto id : std::as_const(windows)) {
-        if (equalIds(id, tgt)) {
-            return id;
-        }
+    WId id = findKnownWindow(tgt);
+    if (id && !transients.contains(id)) {
+        return id;
     }
     return 0;
 }
 
 WId LXQtTaskbarWlrootsBackend::findTopParent(WId winId) const
 {
-    while (getWindow(winId)->parentWindow)
+    while (WId parent = getWindow(winId)->parentWindow)
     {
-        winId = getWindow(winId)->parentWindow;
-        // first search in transients because this may be a child window of another one
-        WId window = 0;
-        for (auto i = transients.cbegin(), end = transients.cend(); i != end; ++i)
-        {
-            if (equalIds(i.key(), winId))
-            {
-                window = i.key();
-                break;
-            }
-        }
-        if (window)
-            winId = window;
-        else
-        {
-            window = findWindow(winId);
-            if (window)
-                winId = window;
-        }
+        // the parent may be a window or a child window of another one
+        WId window = findKnownWindow(parent);
+        winId = window ? window : parent;
     }
     return winId;
 }
 
-void LXQtTaskbarWlrootsBackend::addWindow(WId winId)
+bool LXQtTaskbarWlrootsBackend::hasActiveTransient(WId leader, WId except) const
 {
-    for (auto id : std::as_const(windows))
+    // walk the transients of the leader and of their own transients
+    QList<::zwlr_foreign_toplevel_handle_v1 *> pending{getWindow(leader)->ID};
+    while (!pending.isEmpty())
     {
-        if (id == winId)
+        ::zwlr_foreign_toplevel_handle_v1 *handle = pending.takeLast();
+        for (auto i = children.constFind(handle), end = children.cend(); i != end && i.key() == handle; ++i)
         {
-            return;
+            LXQtTaskbarWlrootsWindow *win = getWindow(i.value());
+            if (i.value() != except && win->windowState.activated)
+                return true;
+            pending << win->ID;
         }
     }
+    return false;
+}
 
-    if (transients.contains(winId))
-    {
+void LXQtTaskbarWlrootsBackend::addWindow(WId winId)
+{
+    LXQtTaskbarWlrootsWindow *window = getWindow(winId);
+    if (window == nullptr) {
         return;
     }
 
-    LXQtTaskbarWlrootsWindow *window = getWindow(winId);
-    if (window == nullptr) {
+    // already known either as a window or as a transient
+    if (handles.value(window->ID, 0) == winId) {
         return;
     }
 
@@ -379,7 +396,7 @@ void LXQtTaskbarWlrootsBackend::addWindow(WId winId)
     // add it either to transients or windows
     if (WId leader = window->parentWindow)
     {
-        transients.insert(winId, leader);
+        insertTransient(winId, leader);
         connect(window, &LXQtTaskbarWlrootsWindow::closed, this, &LXQtTaskbarWlrootsBackend::removeTransient);
     }
     else
@@ -388,6 +405,35 @@ void LXQtTaskbarWlrootsBackend::addWindow(WId winId)
     }
 }
 
+void LXQtTaskbarWlrootsBackend::insertTransient(WId winId, WId leader)
+{
+    ::zwlr_foreign_toplevel_handle_v1 *leaderHandle = getWindow(leader)->ID;
+    transients.insert(winId, leaderHandle);
+    children.insert(leaderHandle, winId);
+    handles.insert(getWindow(winId)->ID, winId);
+}
+
+bool LXQtTaskbarWlrootsBackend::eraseTransient(WId winId)
+{
+    auto it = transients.constFind(winId);
+    if (it == transients.cend())
+        return false;
+
+    children.remove(it.value(), winId);
+    transients.erase(it);
+    handles.remove(getWindow(winId)->ID);
+    return true;
+}
+
+void LXQtTaskbarWlrootsBackend::eraseFromWindows(WId winId)
+{
+    eraseWindow(windows, winId);
+
+    auto it = handles.constFind(getWindow(winId)->ID);
+    if (it != handles.cend() && it.value() == winId)
+        handles.erase(it);
+}
+
 void LXQtTaskbarWlrootsBackend::addToWindows(WId winId)
 {
     LXQtTaskbarWlrootsWindow *window = getWindow(winId);
@@ -396,6 +442,7 @@ void LXQtTaskbarWlrootsBackend::addToWindows(WId winId)
     }
 
     windows.push_back(winId);
+    handles.insert(window->ID, winId);
 
     connect(window, &LXQtTaskbarWlrootsWindow::closed, this, &LXQtTaskbarWlrootsBackend::removeWindow);
     connect(window, &LXQtTaskbarWlrootsWindow::titleChanged, this, &LXQtTaskbarWlrootsBackend::onTitleChanged);
@@ -403,12 +450,13 @@ void LXQtTaskbarWlrootsBackend::addToWindows(WId winId)
     connect(window, &LXQtTaskbarWlrootsWindow::fullscreenChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
     connect(window, &LXQtTaskbarWlrootsWindow::maximizedChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
     connect(window, &LXQtTaskbarWlrootsWindow::minimizedChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
+    connect(window, &LXQtTaskbarWlrootsWindow::done, this, &LXQtTaskbarWlrootsBackend::onDone);
 
     emit windowAdded( winId );
-    emit windowPropertyChanged(winId, int(LXQtTaskBarWindowProperty::WindowClass));
-    emit windowPropertyChanged(winId, int(LXQtTaskBarWindowProperty::Title));
-    emit windowPropertyChanged(winId, int(LXQtTaskBarWindowProperty::Icon));
-    emit windowPropertyChanged(winId, int(LXQtTaskBarWindowProperty::State));
+    announceWindowProperties(winId, windowPropertyBit(LXQtTaskBarWindowProperty::WindowClass)
+                                    | windowPropertyBit(LXQtTaskBarWindowProperty::Title)
+                                    | windowPropertyBit(LXQtTaskBarWindowProperty::Icon)
+                                    | windowPropertyBit(LXQtTaskBarWindowProperty::State));
 }
 
 void LXQtTaskbarWlrootsBackend::removeWindow()
@@ -423,10 +471,12 @@ void LXQtTaskbarWlrootsBackend::removeWindow()
         disconnect(window, &LXQtTaskbarWlrootsWindow::fullscreenChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
         disconnect(window, &LXQtTaskbarWlrootsWindow::maximizedChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
         disconnect(window, &LXQtTaskbarWlrootsWindow::minimizedChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
+        disconnect(window, &LXQtTaskbarWlrootsWindow::done, this, &LXQtTaskbarWlrootsBackend::onDone);
 
         WId winId = window->getWindowId();
-        eraseWindow(windows, winId);
+        eraseFromWindows(winId);
         lastActivated.remove(winId);
+        pendingChanges.remove(winId);
 
         if (activeWindow == winId)
         {
@@ -445,7 +495,7 @@ void LXQtTaskbarWlrootsBackend::removeTransient()
         disconnect(window, &LXQtTaskbarWlrootsWindow::closed, this, &LXQtTaskbarWlrootsBackend::removeTransient);
         disconnect(window, &LXQtTaskbarWlrootsWindow::parentChanged, this, &LXQtTaskbarWlrootsBackend::onParentChanged);
         disconnect(window, &LXQtTaskbarWlrootsWindow::activatedChanged, this, &LXQtTaskbarWlrootsBackend::onActivatedChanged);
-        transients.remove(window->getWindowId());
+        eraseTransient(window->getWindowId());
     }
 }
 
@@ -468,17 +518,8 @@ void LXQtTaskbarWlrootsBackend::onActivatedChanged()
         else
         {
             // First check if it has an active child (transient) window.
-            for (auto i = transients.cbegin(), end = transients.cend(); i != end; ++i)
-            {
-                if (window->getWindowId() != i.key() && equalIds(findTopParent(i.key()), effectiveWindow))
-                {
-                    if (auto win = getWindow(i.key()))
-                    {
-                        if (win->windowState.activated)
-                            return;
-                    }
-                }
-            }
+            if (hasActiveTransient(effectiveWindow, window->getWindowId()))
+                return;
 
             if (activeWindow == effectiveWindow)
             {
@@ -496,12 +537,12 @@ void LXQtTaskbarWlrootsBackend::onParentChanged()
        WId leader = window->parentWindow;
 
         /** Basically, check if this window is a transient */
-        if (transients.remove(window->getWindowId()))
+        if (eraseTransient(window->getWindowId()))
         {
             if (leader)
             {
                 // leader change.
-                transients.insert(window->getWindowId(), leader);
+                insertTransient(window->getWindowId(), leader);
             }
             else
             {
@@ -530,13 +571,15 @@ void LXQtTaskbarWlrootsBackend::onParentChanged()
             disconnect(window, &LXQtTaskbarWlrootsWindow::fullscreenChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
             disconnect(window, &LXQtTaskbarWlrootsWindow::maximizedChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
             disconnect(window, &LXQtTaskbarWlrootsWindow::minimizedChanged, this, &LXQtTaskbarWlrootsBackend::onStateChanged);
-            eraseWindow(windows, window->getWindowId());
+            disconnect(window, &LXQtTaskbarWlrootsWindow::done, this, &LXQtTaskbarWlrootsBackend::onDone);
+            eraseFromWindows(window->getWindowId());
             lastActivated.remove(window->getWindowId());
+            pendingChanges.remove(window->getWindowId());
             // announce that it's removed
             emit windowRemoved(window->getWindowId());
 
             // add it to transients
-            transients.insert(window->getWindowId(), leader);
+            insertTransient(window->getWindowId(), leader);
             connect(window, &LXQtTaskbarWlrootsWindow::closed, this, &LXQtTaskbarWlrootsBackend::removeTransient);
 
             // Correct the activation state if a window that has got a leader was active before.
@@ -552,22 +595,38 @@ void LXQtTaskbarWlrootsBackend::onParentChanged()
     }
 }
 
+/*
+ * The changes of a window are collected until the compositor sends done,
+ * which ends the batch; then they are announced at once.
+ */
+
 void LXQtTaskbarWlrootsBackend::onTitleChanged()
 {
     if (auto window = qobject_cast<LXQtTaskbarWlrootsWindow *>(QObject::sender()))
-        emit windowPropertyChanged(window->getWindowId(), int(LXQtTaskBarWindowProperty::Title));
+        pendingChanges[window->getWindowId()] |= windowPropertyBit(LXQtTaskBarWindowProperty::Title);
 }
 
 void LXQtTaskbarWlrootsBackend::onAppIdChanged()
 {
+    // the icon is looked up by the app id
     if (auto window = qobject_cast<LXQtTaskbarWlrootsWindow *>(QObject::sender()))
-        emit windowPropertyChanged(window->getWindowId(), int(LXQtTaskBarWindowProperty::WindowClass));
+        pendingChanges[window->getWindowId()] |= windowPropertyBit(LXQtTaskBarWindowProperty::WindowClass)
+                                                 | windowPropertyBit(LXQtTaskBarWindowProperty::Icon);
 }
 
 void LXQtTaskbarWlrootsBackend::onStateChanged()
 {
     if (auto window = qobject_cast<LXQtTaskbarWlrootsWindow *>(QObject::sender()))
-        emit windowPropertyChanged(window->getWindowId(), int(LXQtTaskBarWindowProperty::State));
+        pendingChanges[window->getWindowId()] |= windowPropertyBit(LXQtTaskBarWindowProperty::State);
+}
+
+void LXQtTaskbarWlrootsBackend::onDone()
+{
+    if (auto window = qobject_cast<LXQtTaskbarWlrootsWindow *>(QObject::sender()))
+    {
+        if (int props = pendingChanges.take(window->getWindowId()))
+            announceWindowProperties(window->getWindowId(), props);
+    }
 }
 
 bool LXQtTaskbarWlrootsBackend::acceptWindow(WId window) const
@@ -589,22 +648,6 @@ LXQtTaskbarWlrootsWindow *LXQtTaskbarWlrootsBackend::getWindow(WId windowId) con
     return nullptr;
 }
 
-bool LXQtTaskbarWlrootsBackend::equalIds(WId windowId1, WId windowId2) const
-{
-    if (windowId1 == windowId2) {
-        return true;
-    }
-    LXQtTaskbarWlrootsWindow *win1 = reinterpret_cast<LXQtTaskbarWlrootsWindow *>( windowId1 );
-    LXQtTaskbarWlrootsWindow *win2 = reinterpret_cast<LXQtTaskbarWlrootsWindow *>( windowId2 );
-    if (win1 == nullptr && win2 == nullptr) {
-        return true;
-    }
-    if (win1 != nullptr && win2 != nullptr) {
-        return win1->ID == win2->ID;
-    }
-    return false;
-}
-
 
 int LXQtWMBackendWlrootsLibrary::getBackendScore(const QString& key) const
 {
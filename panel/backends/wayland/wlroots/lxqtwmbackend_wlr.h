@@ -6,6 +6,8 @@
 #include <QHash>
 #include <vector>
 
+struct zwlr_foreign_toplevel_handle_v1;
+
 class LXQtTaskbarWlrootsWindow;
 class LXQtTaskbarWlrootsWindowManagment;
 class LXQtWlrootsWaylandWorkspaceInfo;
@@ -43,6 +45,8 @@ public:
 
     virtual WId getActiveWindow() const override;
 
+    virtual LXQtTaskBarWindowSnapshot getWindowSnapshot(WId windowId) const override;
+
     // Workspaces
     virtual int getWorkspacesCount() const override;
     virtual QString getWorkspaceName(int idx) const override;
@@ -81,13 +85,18 @@ private slots:
     void onTitleChanged();
     void onAppIdChanged();
     void onStateChanged();
+    void onDone();
 
 private:
     void addToWindows(WId winId);
+    void eraseFromWindows(WId winId);
+    void insertTransient(WId winId, WId leader);
+    bool eraseTransient(WId winId);
     bool acceptWindow(WId wid) const;
+    WId findKnownWindow(WId tgt) const;
     WId findWindow(WId tgt) const;
     WId findTopParent(WId winId) const;
-    bool equalIds(WId windowId1, WId windowId2) const;
+    bool hasActiveTransient(WId leader, WId except) const;
 
     /** Convert WId (i.e. quintptr into LXQtTaskbarWlrootsWindow*) */
     LXQtTaskbarWlrootsWindow *getWindow(WId windowId) const;
@@ -98,15 +107,28 @@ private:
     WId activeWindow = 0;
     std::vector<WId> windows;
 
-    // key=transient child, value=leader
-    QHash<WId, WId> transients;
+    // key=window, value=mask of its properties changed in the current batch
+    QHash<WId, int> pendingChanges;
+
+    // key=transient child, value=handle of its leader
+    QHash<WId, ::zwlr_foreign_toplevel_handle_v1 *> transients;
+
+    // key=handle of a leader, values=its transient children
+    QMultiHash<::zwlr_foreign_toplevel_handle_v1 *, WId> children;
+
+    /**
+     * The known windows and transients by their toplevel handle. A parent
+     * is reported as a new proxy of the leader's handle, so this maps it
+     * back to the id under which the leader is known.
+     */
+    QHash<::zwlr_foreign_toplevel_handle_v1 *, WId> handles;
 };
 
 
 class LXQtWMBackendWlrootsLibrary: public QObject, public ILXQtWMBackendLibrary
 {
     Q_OBJECT
-    Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0")
+    Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0" FILE "lxqtwmbackend_wlr.json")
     Q_INTERFACES(ILXQtWMBackendLibrary)
 public:
     int getBackendScore(const QString& key) const override;
@@ -35,15 +35,163 @@
 // Necessary for closeApplication()
 #include <NETWM>
 
+#include <QCryptographicHash>
 #include <QGuiApplication>
+#include <QImage>
 #include <QScreen>
 
 #include <QTimer>
 
+#include <cstdlib>
+#include <memory>
+
+#include <xcb/xcb.h>
+
 //NOTE: Xlib.h defines Bool which conflicts with QJsonValue::Type enum
 #include <X11/Xlib.h>
 #undef Bool
 
+namespace
+{
+struct AtomValue
+{
+    const char *name;
+    int value;
+};
+
+const AtomValue windowTypeAtoms[] = {
+    {"_NET_WM_WINDOW_TYPE_NORMAL", NET::Normal},
+    {"_NET_WM_WINDOW_TYPE_DESKTOP", NET::Desktop},
+    {"_NET_WM_WINDOW_TYPE_DOCK", NET::Dock},
+    {"_NET_WM_WINDOW_TYPE_TOOLBAR", NET::Toolbar},
+    {"_NET_WM_WINDOW_TYPE_MENU", NET::Menu},
+    {"_NET_WM_WINDOW_TYPE_DIALOG", NET::Dialog},
+    {"_NET_WM_WINDOW_TYPE_UTILITY", NET::Utility},
+    {"_NET_WM_WINDOW_TYPE_SPLASH", NET::Splash},
+    {"_NET_WM_WINDOW_TYPE_DROPDOWN_MENU", NET::DropdownMenu},
+    {"_NET_WM_WINDOW_TYPE_POPUP_MENU", NET::PopupMenu},
+    {"_NET_WM_WINDOW_TYPE_TOOLTIP", NET::Tooltip},
+    {"_NET_WM_WINDOW_TYPE_NOTIFICATION", NET::Notification},
+    {"_NET_WM_WINDOW_TYPE_COMBO", NET::ComboBox},
+    {"_NET_WM_WINDOW_TYPE_DND", NET::DNDIcon},
+    {"_KDE_NET_WM_WINDOW_TYPE_OVERRIDE", NET::Override},
+    {"_KDE_NET_WM_WINDOW_TYPE_TOPMENU", NET::TopMenu},
+    {"_KDE_NET_WM_WINDOW_TYPE_ON_SCREEN_DISPLAY", NET::OnScreenDisplay},
+    {"_KDE_NET_WM_WINDOW_TYPE_CRITICAL_NOTIFICATION", NET::CriticalNotification},
+    {"_KDE_NET_WM_WINDOW_TYPE_APPLET_POPUP", NET::AppletPopup},
+};
+
+const AtomValue stateAtoms[] = {
+    {"_NET_WM_STATE_MODAL", NET::Modal},
+    {"_NET_WM_STATE_STICKY", NET::Sticky},
+    {"_NET_WM_STATE_MAXIMIZED_VERT", NET::MaxVert},
+    {"_NET_WM_STATE_MAXIMIZED_HORZ", NET::MaxHoriz},
+    {"_NET_WM_STATE_SHADED", NET::Shaded},
+    {"_NET_WM_STATE_SKIP_TASKBAR", NET::SkipTaskbar},
+    {"_NET_WM_STATE_SKIP_PAGER", NET::SkipPager},
+    {"_NET_WM_STATE_HIDDEN", NET::Hidden},
+    {"_NET_WM_STATE_FULLSCREEN", NET::FullScreen},
+    {"_NET_WM_STATE_ABOVE", NET::KeepAbove},
+    {"_NET_WM_STATE_BELOW", NET::KeepBelow},
+    {"_NET_WM_STATE_DEMANDS_ATTENTION", NET::DemandsAttention},
+    {"_NET_WM_STATE_FOCUSED", NET::Focused},
+    {"_KDE_NET_WM_STATE_SKIP_SWITCHER", NET::SkipSwitcher},
+};
+
+const AtomValue actionAtoms[] = {
+    {"_NET_WM_ACTION_MOVE", NET::ActionMove},
+    {"_NET_WM_ACTION_RESIZE", NET::ActionResize},
+    {"_NET_WM_ACTION_MINIMIZE", NET::ActionMinimize},
+    {"_NET_WM_ACTION_SHADE", NET::ActionShade},
+    {"_NET_WM_ACTION_STICK", NET::ActionStick},
+    {"_NET_WM_ACTION_MAXIMIZE_VERT", NET::ActionMaxVert},
+    {"_NET_WM_ACTION_MAXIMIZE_HORZ", NET::ActionMaxHoriz},
+    {"_NET_WM_ACTION_FULLSCREEN", NET::ActionFullScreen},
+    {"_NET_WM_ACTION_CHANGE_DESKTOP", NET::ActionChangeDesktop},
+    {"_NET_WM_ACTION_CLOSE", NET::ActionClose},
+};
+
+// The actions of the window manager asked for by the taskbar
+const NET::Action windowActions[] = {NET::ActionMove, NET::ActionResize, NET::ActionMax, NET::ActionMaxVert,
+                                     NET::ActionMaxHoriz, NET::ActionMinimize, NET::ActionShade, NET::ActionFullScreen};
+
+// The window manager action needed for an action, 0 if the action is always supported
+NET::Action netAction(LXQtTaskBarBackendAction action)
+{
+    switch (action)
+    {
+    case LXQtTaskBarBackendAction::Move:
+        return NET::ActionMove;
+
+    case LXQtTaskBarBackendAction::Resize:
+        return NET::ActionResize;
+
+    case LXQtTaskBarBackendAction::Maximize:
+        return NET::ActionMax;
+
+    case LXQtTaskBarBackendAction::MaximizeVertically:
+        return NET::ActionMaxVert;
+
+    case LXQtTaskBarBackendAction::MaximizeHorizontally:
+        return NET::ActionMaxHoriz;
+
+    case LXQtTaskBarBackendAction::Minimize:
+        return NET::ActionMinimize;
+
+    case LXQtTaskBarBackendAction::RollUp:
+        return NET::ActionShade;
+
+    case LXQtTaskBarBackendAction::FullScreen:
+        return NET::ActionFullScreen;
+
+    default: // DesktopSwitch, MoveToDesktop, MoveToLayer and MoveToOutput
+        return NET::Action(0);
+    }
+}
+
+// from ICCCM, xcb-icccm is not needed for just these
+const quint32 iconicState = 3;
+const quint32 urgencyHint = 1 << 8;
+
+template <typename T>
+using XcbReply = std::unique_ptr<T, decltype(&free)>;
+
+// Returns the reply of a request, or an empty pointer on error (e.g. if the window is gone)
+XcbReply<xcb_get_property_reply_t> propertyReply(xcb_connection_t *c, xcb_get_property_cookie_t cookie)
+{
+    xcb_generic_error_t *error = nullptr;
+    xcb_get_property_reply_t *reply = xcb_get_property_reply(c, cookie, &error);
+    free(error);
+    if (reply && reply->type == XCB_ATOM_NONE)
+    {
+        free(reply);
+        reply = nullptr;
+    }
+    return XcbReply<xcb_get_property_reply_t>(reply, &free);
+}
+
+// The values of a 32 bit property
+QVector<quint32> cardinals(const xcb_get_property_reply_t *reply)
+{
+    QVector<quint32> values;
+    if (reply && reply->format == 32)
+    {
+        const quint32 *data = static_cast<const quint32 *>(xcb_get_property_value(reply));
+        values.reserve(reply->value_len);
+        for (quint32 i = 0; i < reply->value_len; ++i)
+            values << data[i];
+    }
+    return values;
+}
+
+QByteArray bytes(const xcb_get_property_reply_t *reply)
+{
+    if (!reply || reply->format != 8)
+        return QByteArray();
+    return QByteArray(static_cast<const char *>(xcb_get_property_value(reply)), xcb_get_property_value_length(reply));
+}
+}
+
 LXQtWMBackendX11::LXQtWMBackendX11(QObject *parent)
     : ILXQtAbstractWMInterface(parent)
 {
@@ -70,7 +218,15 @@ LXQtWMBackendX11::LXQtWMBackendX11(QObject *parent)
  ************************************************/
 void LXQtWMBackendX11::onWindowChanged(WId windowId, NET::Properties prop, NET::Properties2 prop2)
 {
-    if(!m_windows.contains(windowId))
+    // update the tracker before the panel is notified and checks the overlap
+    if (m_overlapTracked
+        && (prop & (NET::WMGeometry | NET::WMFrameExtents | NET::WMState | NET::WMDesktop | NET::WMWindowType)))
+    {
+        trackOverlap(windowId);
+    }
+
+    auto rec = m_records.find(windowId);
+    if(rec == m_records.end())
     {
         // If already known window changes its property in a way
         // it's now acceptable, add it again to taskbar
@@ -79,14 +235,23 @@ void LXQtWMBackendX11::onWindowChanged(WId windowId, NET::Properties prop, NET::
         return;
     }
 
-    if(!acceptWindow(windowId))
+    // only the properties checked by acceptWindow() can change the acceptance
+    if(((prop & (NET::WMWindowType | NET::WMState)) || prop2.testFlag(NET::WM2TransientFor))
+        && !acceptWindow(windowId))
     {
         // If already known window changes its property in a way
         // it's not anymore accepted, remove it from taskbar
-        onWindowRemoved(windowId);
+        // (it still exists, so it is kept in the overlap tracker)
+        removeWindow_internal(windowId);
         return;
     }
 
+    // update the cache before the consumers are notified and ask for the values
+    const int oldDesktop = rec->desktop;
+    updateRecord(*rec, windowId, prop, prop2);
+    if (prop.testFlag(NET::WMIcon) || prop2.testFlag(NET::WM2WindowClass))
+        dropIcons(windowId);
+
     if (prop.testFlag(NET::WMGeometry))
     {
         emit windowPropertyChanged(windowId, int(LXQtTaskBarWindowProperty::Geometry));
@@ -97,8 +262,8 @@ void LXQtWMBackendX11::onWindowChanged(WId windowId, NET::Properties prop, NET::
         emit windowPropertyChanged(windowId, int(LXQtTaskBarWindowProperty::WindowClass));
     }
 
-    // window changed virtual desktop
-    if (prop.testFlag(NET::WMDesktop))
+    // window changed virtual desktop (or viewport, see updateRecord())
+    if (prop.testFlag(NET::WMDesktop) || rec->desktop != oldDesktop)
     {
         emit windowPropertyChanged(windowId, int(LXQtTaskBarWindowProperty::Workspace));
     }
@@ -130,6 +295,9 @@ void LXQtWMBackendX11::onWindowChanged(WId windowId, NET::Properties prop, NET::
 
 void LXQtWMBackendX11::onWindowAdded(WId windowId)
 {
+    if (m_overlapTracked)
+        trackOverlap(windowId);
+
     if(m_windows.contains(windowId))
         return;
 
@@ -141,13 +309,10 @@ void LXQtWMBackendX11::onWindowAdded(WId windowId)
 
 void LXQtWMBackendX11::onWindowRemoved(WId windowId)
 {
-    const int row = m_windows.indexOf(windowId);
-    if(row == -1)
-        return;
-
-    m_windows.removeAt(row);
+    if (m_overlapTracked)
+        untrackOverlap(windowId);
 
-    emit windowRemoved(windowId);
+    removeWindow_internal(windowId);
 }
 
 /************************************************
@@ -194,87 +359,454 @@ bool LXQtWMBackendX11::acceptWindow(WId windowId) const
 
 void LXQtWMBackendX11::addWindow_internal(WId windowId)
 {
+    // the record may have been filled by fetchWindows() already
+    if (!m_records.contains(windowId))
+    {
+        WindowRecord &rec = m_records[windowId];
+        updateRecord(rec, windowId, NET::WMName | NET::WMVisibleName | NET::WMState | NET::XAWMState | NET::WMDesktop | NET::WMGeometry | NET::WMFrameExtents,
+                     NET::WM2WindowClass | NET::WM2AllowedActions | NET::WM2Urgency);
+    }
+
     m_windows.append(windowId);
     emit windowAdded(windowId);
 }
 
+void LXQtWMBackendX11::removeWindow_internal(WId windowId)
+{
+    const int row = m_windows.indexOf(windowId);
+    if(row == -1)
+        return;
+
+    m_windows.removeAt(row);
+    m_records.remove(windowId);
+    dropIcons(windowId);
 
-/************************************************
- *   Windows function
- ************************************************/
-bool LXQtWMBackendX11::supportsAction(WId windowId, LXQtTaskBarBackendAction action) const
+    emit windowRemoved(windowId);
+}
+
+void LXQtWMBackendX11::updateRecord(WindowRecord &record, WId windowId, NET::Properties prop, NET::Properties2 prop2) const
 {
-    NET::Action x11Action;
+    // some values are computed from several properties
+    // on viewport WMs, KWindowInfo::desktop() is derived from the geometry and the sticky state
+    if (KX11Extras::mapViewport() && (prop & (NET::WMDesktop | NET::WMGeometry | NET::WMFrameExtents | NET::WMState)))
+        prop |= NET::WMDesktop | NET::WMGeometry | NET::WMState;
+    if (prop & (NET::WMName | NET::WMVisibleName))
+        prop |= NET::WMName | NET::WMVisibleName;
+    if (prop & (NET::WMState | NET::XAWMState))
+        prop |= NET::WMState | NET::XAWMState;
+    if (prop & (NET::WMGeometry | NET::WMFrameExtents))
+        prop |= NET::WMGeometry | NET::WMFrameExtents;
+    prop &= NET::WMName | NET::WMVisibleName | NET::WMState | NET::XAWMState | NET::WMDesktop | NET::WMGeometry | NET::WMFrameExtents;
+    const NET::Properties2 infoProp2 = prop2 & (NET::WM2WindowClass | NET::WM2AllowedActions);
+
+    if (prop || infoProp2)
+    {
+        // one KWindowInfo for all the changed properties
+        KWindowInfo info(windowId, prop, infoProp2);
+        if (prop.testFlag(NET::WMName))
+            record.title = info.visibleName().isEmpty() ? info.name() : info.visibleName();
+        if (prop.testFlag(NET::WMState))
+        {
+            record.state = info.state();
+            record.minimized = info.isMinimized();
+        }
+        if (prop.testFlag(NET::WMDesktop))
+            record.desktop = info.desktop();
+        if (prop.testFlag(NET::WMGeometry))
+            record.frameGeometry = info.frameGeometry();
+        if (infoProp2.testFlag(NET::WM2WindowClass))
+            record.windowClass = QString::fromUtf8(info.windowClassClass());
+        if (infoProp2.testFlag(NET::WM2AllowedActions))
+        {
+            record.allowedActions = NET::Actions();
+            for (const NET::Action action : windowActions)
+            {
+                if (info.actionSupported(action))
+                    record.allowedActions |= action;
+            }
+        }
+    }
 
-    switch (action)
+    if (prop2.testFlag(NET::WM2Urgency))
     {
-    case LXQtTaskBarBackendAction::Move:
-        x11Action = NET::ActionMove;
-        break;
+        WId appRootWindow = XDefaultRootWindow(m_X11Display);
+        record.urgency = NETWinInfo(m_xcbConnection, windowId, appRootWindow, NET::Properties{}, NET::WM2Urgency).urgency();
+    }
+}
 
-    case LXQtTaskBarBackendAction::Resize:
-        x11Action = NET::ActionResize;
-        break;
+const LXQtWMBackendX11::WindowRecord *LXQtWMBackendX11::record(WId windowId) const
+{
+    auto rec = m_records.constFind(windowId);
+    return rec == m_records.cend() ? nullptr : &*rec;
+}
 
-    case LXQtTaskBarBackendAction::Maximize:
-        x11Action = NET::ActionMax;
-        break;
+void LXQtWMBackendX11::internFetchAtoms()
+{
+    if (m_fetchAtomsInterned)
+        return;
+    m_fetchAtomsInterned = true;
+
+    const char *const names[] = {"_NET_WM_WINDOW_TYPE", "_NET_WM_STATE", "_NET_WM_NAME", "_NET_WM_VISIBLE_NAME",
+                                 "UTF8_STRING", "WM_STATE", "_NET_WM_DESKTOP", "_NET_FRAME_EXTENTS",
+                                 "_NET_WM_ALLOWED_ACTIONS"};
+    quint32 *const targets[] = {&m_fetchAtoms.windowType, &m_fetchAtoms.state, &m_fetchAtoms.name, &m_fetchAtoms.visibleName,
+                                &m_fetchAtoms.utf8String, &m_fetchAtoms.wmState, &m_fetchAtoms.desktop, &m_fetchAtoms.frameExtents,
+                                &m_fetchAtoms.allowedActions};
+
+    auto intern = [this] (const char *name) {
+        return xcb_intern_atom(m_xcbConnection, false, static_cast<quint16>(qstrlen(name)), name);
+    };
+    auto atom = [this] (xcb_intern_atom_cookie_t cookie) {
+        XcbReply<xcb_intern_atom_reply_t> reply(xcb_intern_atom_reply(m_xcbConnection, cookie, nullptr), &free);
+        return reply ? quint32(reply->atom) : quint32(XCB_ATOM_NONE);
+    };
+
+    // send all the requests first
+    QVector<xcb_intern_atom_cookie_t> cookies;
+    for (const char *name : names)
+        cookies << intern(name);
+    for (const AtomValue &type : windowTypeAtoms)
+        cookies << intern(type.name);
+    for (const AtomValue &state : stateAtoms)
+        cookies << intern(state.name);
+    for (const AtomValue &action : actionAtoms)
+        cookies << intern(action.name);
+
+    int i = 0;
+    for (quint32 *target : targets)
+        *target = atom(cookies.at(i++));
+    for (const AtomValue &type : windowTypeAtoms)
+        m_fetchAtoms.types.insert(atom(cookies.at(i++)), type.value);
+    for (const AtomValue &state : stateAtoms)
+        m_fetchAtoms.states.insert(atom(cookies.at(i++)), state.value);
+    for (const AtomValue &action : actionAtoms)
+        m_fetchAtoms.actions.insert(atom(cookies.at(i++)), action.value);
+}
 
-    case LXQtTaskBarBackendAction::MaximizeVertically:
-        x11Action = NET::ActionMaxVert;
-        break;
+QVector<WId> LXQtWMBackendX11::fetchWindows(const QList<WId> &windows)
+{
+    QVector<WId> accepted;
 
-    case LXQtTaskBarBackendAction::MaximizeHorizontally:
-        x11Action = NET::ActionMaxHoriz;
-        break;
+    // KWindowInfo treats the desktops of viewport WMs specially, don't duplicate that
+    if (KX11Extras::mapViewport())
+    {
+        for (const WId windowId : windows)
+        {
+            if (acceptWindow(windowId))
+                accepted << windowId;
+        }
+        return accepted;
+    }
 
-    case LXQtTaskBarBackendAction::Minimize:
-        x11Action = NET::ActionMinimize;
-        break;
+    internFetchAtoms();
+    const FetchAtoms &atoms = m_fetchAtoms;
+    const xcb_window_t root = XDefaultRootWindow(m_X11Display);
 
-    case LXQtTaskBarBackendAction::RollUp:
-        x11Action = NET::ActionShade;
-        break;
+    struct Cookies
+    {
+        xcb_get_geometry_cookie_t geometry;
+        xcb_translate_coordinates_cookie_t position;
+        xcb_get_property_cookie_t type;
+        xcb_get_property_cookie_t state;
+        xcb_get_property_cookie_t transientFor;
+        xcb_get_property_cookie_t name;
+        xcb_get_property_cookie_t visibleName;
+        xcb_get_property_cookie_t wmName;
+        xcb_get_property_cookie_t wmClass;
+        xcb_get_property_cookie_t wmState;
+        xcb_get_property_cookie_t desktop;
+        xcb_get_property_cookie_t frameExtents;
+        xcb_get_property_cookie_t allowedActions;
+        xcb_get_property_cookie_t hints;
+    };
+
+    // 1. everything about all the windows
+    QVector<Cookies> cookies;
+    cookies.reserve(windows.size());
+    for (const WId windowId : windows)
+    {
+        const xcb_window_t w = windowId;
+        Cookies c;
+        c.geometry = xcb_get_geometry_unchecked(m_xcbConnection, w);
+        c.position = xcb_translate_coordinates_unchecked(m_xcbConnection, w, root, 0, 0);
+        c.type = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.windowType, XCB_ATOM_ATOM, 0, 256);
+        c.state = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.state, XCB_ATOM_ATOM, 0, 256);
+        c.transientFor = xcb_get_property_unchecked(m_xcbConnection, false, w, XCB_ATOM_WM_TRANSIENT_FOR, XCB_ATOM_WINDOW, 0, 1);
+        c.name = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.name, atoms.utf8String, 0, 2048);
+        c.visibleName = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.visibleName, atoms.utf8String, 0, 2048);
+        c.wmName = xcb_get_property_unchecked(m_xcbConnection, false, w, XCB_ATOM_WM_NAME, XCB_GET_PROPERTY_TYPE_ANY, 0, 2048);
+        c.wmClass = xcb_get_property_unchecked(m_xcbConnection, false, w, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 0, 2048);
+        c.wmState = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.wmState, atoms.wmState, 0, 2);
+        c.desktop = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.desktop, XCB_ATOM_CARDINAL, 0, 1);
+        c.frameExtents = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.frameExtents, XCB_ATOM_CARDINAL, 0, 4);
+        c.allowedActions = xcb_get_property_unchecked(m_xcbConnection, false, w, atoms.allowedActions, XCB_ATOM_ATOM, 0, 256);
+        c.hints = xcb_get_property_unchecked(m_xcbConnection, false, w, XCB_ATOM_WM_HINTS, XCB_ATOM_WM_HINTS, 0, 9);
+        cookies << c;
+    }
 
-    case LXQtTaskBarBackendAction::FullScreen:
-        x11Action = NET::ActionFullScreen;
-        break;
+    // the first known type, as in NETWinInfo::windowType()
+    auto windowType = [&atoms] (const xcb_get_property_reply_t *reply) {
+        const QVector<quint32> values = cardinals(reply);
+        for (const quint32 value : values)
+        {
+            auto type = atoms.types.constFind(value);
+            if (type != atoms.types.cend())
+                return NET::WindowType(*type);
+        }
+        return NET::Unknown;
+    };
 
-    case LXQtTaskBarBackendAction::DesktopSwitch:
-        return true;
+    QFlags<NET::WindowTypeMask> ignoreList;
+    ignoreList |= NET::DesktopMask;
+    ignoreList |= NET::DockMask;
+    ignoreList |= NET::SplashMask;
+    ignoreList |= NET::ToolbarMask;
+    ignoreList |= NET::MenuMask;
+    ignoreList |= NET::PopupMenuMask;
+    ignoreList |= NET::NotificationMask;
 
-    case LXQtTaskBarBackendAction::MoveToDesktop:
-        return true;
+    QFlags<NET::WindowTypeMask> normalFlag;
+    normalFlag |= NET::NormalMask;
+    normalFlag |= NET::DialogMask;
+    normalFlag |= NET::UtilityMask;
 
-    case LXQtTaskBarBackendAction::MoveToLayer:
-        return true;
+    const bool allowedActionsSupported = NETRootInfo(m_xcbConnection, NET::Supported).isSupported(NET::WM2AllowedActions);
+    const bool icccmCompliantMappingState = KX11Extras::icccmCompliantMappingState();
 
-    case LXQtTaskBarBackendAction::MoveToOutput:
-        return true;
+    QHash<WId, NET::WindowType> types; // of all the valid windows, for the transient-for lookup
+    QVector<QPair<WId, WindowRecord>> candidates;
+    QVector<QPair<WId, WId>> transients; // candidates which need the type of their transient-for window
+    for (int i = 0; i < windows.size(); ++i)
+    {
+        const WId windowId = windows.at(i);
+        const Cookies &c = cookies.at(i);
+
+        XcbReply<xcb_get_geometry_reply_t> geometry(xcb_get_geometry_reply(m_xcbConnection, c.geometry, nullptr), &free);
+        XcbReply<xcb_translate_coordinates_reply_t> position(xcb_translate_coordinates_reply(m_xcbConnection, c.position, nullptr), &free);
+        const auto type = propertyReply(m_xcbConnection, c.type);
+        const auto state = propertyReply(m_xcbConnection, c.state);
+        const auto transientFor = propertyReply(m_xcbConnection, c.transientFor);
+        const auto name = propertyReply(m_xcbConnection, c.name);
+        const auto visibleName = propertyReply(m_xcbConnection, c.visibleName);
+        const auto wmName = propertyReply(m_xcbConnection, c.wmName);
+        const auto wmClass = propertyReply(m_xcbConnection, c.wmClass);
+        const auto wmState = propertyReply(m_xcbConnection, c.wmState);
+        const auto desktop = propertyReply(m_xcbConnection, c.desktop);
+        const auto frameExtents = propertyReply(m_xcbConnection, c.frameExtents);
+        const auto allowedActions = propertyReply(m_xcbConnection, c.allowedActions);
+        const auto hints = propertyReply(m_xcbConnection, c.hints);
+
+        if (!geometry || !position)
+            continue; // the window is gone
+
+        const QVector<quint32> transientValues = cardinals(transientFor.get());
+        const WId transFor = transientValues.isEmpty() ? 0 : transientValues.first();
+
+        // per spec, a window without type is a dialog if it is transient, else a normal window
+        NET::WindowType winType = windowType(type.get());
+        types.insert(windowId, type ? winType : NET::Normal);
+        if (!type)
+            winType = transFor != 0 ? NET::Dialog : NET::Normal;
+
+        WindowRecord rec;
+        const QVector<quint32> stateValues = cardinals(state.get());
+        for (const quint32 value : stateValues)
+            rec.state |= NET::State(atoms.states.value(value, 0));
+
+        if (NET::typeMatchesMask(winType, ignoreList) || (rec.state & NET::SkipTaskbar))
+            continue;
+
+        // the same fallbacks as KWindowInfo::visibleName() and name()
+        rec.title = QString::fromUtf8(bytes(visibleName.get()));
+        if (rec.title.isEmpty())
+            rec.title = QString::fromUtf8(bytes(name.get()));
+        if (rec.title.isEmpty() && wmName)
+        {
+            if (wmName->type == XCB_ATOM_STRING)
+                rec.title = QString::fromLatin1(bytes(wmName.get()));
+            else if (wmName->type == atoms.utf8String)
+                rec.title = QString::fromUtf8(bytes(wmName.get()));
+            else
+                rec.title = KX11Extras::readNameProperty(windowId, XCB_ATOM_WM_NAME);
+        }
 
-    default:
-        return false;
+        // WM_CLASS is "instance\0class\0"
+        const QList<QByteArray> classParts = bytes(wmClass.get()).split('\0');
+        if (classParts.size() > 1)
+            rec.windowClass = QString::fromUtf8(classParts.at(1));
+
+        // as KWindowInfo::isMinimized(): iconic and hidden, but not shaded,
+        // or just iconic if the WM does not use _NET_WM_STATE_HIDDEN
+        const QVector<quint32> wmStateValues = cardinals(wmState.get());
+        const bool iconic = !wmStateValues.isEmpty() && wmStateValues.first() == iconicState;
+        rec.minimized = (iconic && (rec.state & NET::Hidden) && !(rec.state & NET::Shaded))
+                        || (iconic && !icccmCompliantMappingState);
+
+        const QVector<quint32> hintsValues = cardinals(hints.get());
+        rec.urgency = !hintsValues.isEmpty() && (hintsValues.first() & urgencyHint);
+
+        const QVector<quint32> desktopValues = cardinals(desktop.get());
+        if (!desktopValues.isEmpty())
+            rec.desktop = desktopValues.first() == 0xFFFFFFFF ? int(NET::OnAllDesktops) : int(desktopValues.first()) + 1;
+
+        QMargins extents;
+        const QVector<quint32> extentValues = cardinals(frameExtents.get());
+        if (extentValues.size() == 4)
+            extents = QMargins(int(extentValues.at(0)), int(extentValues.at(2)), int(extentValues.at(1)), int(extentValues.at(3)));
+        rec.frameGeometry = QRect(position->dst_x, position->dst_y, geometry->width, geometry->height) + extents;
+
+        if (allowedActionsSupported)
+        {
+            const QVector<quint32> actionValues = cardinals(allowedActions.get());
+            for (const quint32 value : actionValues)
+                rec.allowedActions |= NET::Action(atoms.actions.value(value, 0));
+        }
+        else
+        {
+            rec.allowedActions = NET::Actions(QFlag(~0));
+        }
+
+        // WM_TRANSIENT_FOR hint not set - normal window
+        if (transFor != 0 && transFor != windowId && transFor != root)
+            transients << qMakePair(windowId, transFor);
+        candidates << qMakePair(windowId, rec);
+    }
+
+    // 2. the types of the transient-for windows which are not in the list
+    QHash<WId, xcb_get_property_cookie_t> parentCookies;
+    for (const auto &transient : std::as_const(transients))
+    {
+        if (!types.contains(transient.second) && !parentCookies.contains(transient.second))
+            parentCookies.insert(transient.second,
+                                 xcb_get_property_unchecked(m_xcbConnection, false, transient.second, atoms.windowType, XCB_ATOM_ATOM, 0, 256));
+    }
+    for (auto it = parentCookies.cbegin(), it_end = parentCookies.cend(); it != it_end; ++it)
+    {
+        const auto type = propertyReply(m_xcbConnection, it.value());
+        types.insert(it.key(), type ? windowType(type.get()) : NET::Normal);
     }
 
+    QSet<WId> rejected;
+    for (const auto &transient : std::as_const(transients))
+    {
+        // transient for a normal window, the parent is shown instead
+        if (NET::typeMatchesMask(types.value(transient.second, NET::Normal), normalFlag))
+            rejected.insert(transient.first);
+    }
+
+    for (const auto &candidate : std::as_const(candidates))
+    {
+        if (rejected.contains(candidate.first))
+            continue;
+        m_records.insert(candidate.first, candidate.second);
+        accepted << candidate.first;
+    }
+    return accepted;
+}
+
+void LXQtWMBackendX11::trackOverlap(WId windowId) const
+{
+    QFlags<NET::WindowTypeMask> ignoreList;
+    ignoreList |= NET::DesktopMask;
+    ignoreList |= NET::DockMask;
+    ignoreList |= NET::SplashMask;
+    ignoreList |= NET::MenuMask;
+    ignoreList |= NET::PopupMenuMask;
+    ignoreList |= NET::DropdownMenuMask;
+    ignoreList |= NET::TopMenuMask;
+    ignoreList |= NET::NotificationMask;
+
+    untrackOverlap(windowId);
+
+    KWindowInfo info(windowId, NET::WMWindowType | NET::WMState | NET::WMFrameExtents | NET::WMDesktop);
+    if (!info.valid()
+        // skip shaded, minimized or hidden windows
+        || (info.state() & (NET::Shaded | NET::Hidden))
+        // check against the list of ignored types
+        || NET::typeMatchesMask(info.windowType(NET::AllTypesMask), ignoreList))
+    {
+        return;
+    }
+
+    const int desktop = info.onAllDesktops() ? int(NET::OnAllDesktops) : info.desktop();
+    m_overlapWindows.insert(windowId, {info.frameGeometry(), desktop});
+    m_overlapBuckets[desktop].insert(windowId);
+}
+
+void LXQtWMBackendX11::untrackOverlap(WId windowId) const
+{
+    auto it = m_overlapWindows.find(windowId);
+    if (it == m_overlapWindows.end())
+        return;
+
+    auto bucket = m_overlapBuckets.find(it->desktop);
+    if (bucket != m_overlapBuckets.end())
+    {
+        bucket->remove(windowId);
+        if (bucket->isEmpty())
+            m_overlapBuckets.erase(bucket);
+    }
+    m_overlapWindows.erase(it);
+}
+
+
+/************************************************
+ *   Windows function
+ ************************************************/
+bool LXQtWMBackendX11::supportsAction(WId windowId, LXQtTaskBarBackendAction action) const
+{
+    const NET::Action x11Action = netAction(action);
+    if (x11Action == 0)
+        return true;
+
+    if (const WindowRecord *rec = record(windowId))
+        return rec->allowedActions.testFlag(x11Action);
+
     KWindowInfo info(windowId, NET::Properties(), NET::WM2AllowedActions);
     return info.actionSupported(x11Action);
 }
 
+int LXQtWMBackendX11::getSupportedActions(WId windowId) const
+{
+    NET::Actions allowedActions;
+    if (const WindowRecord *rec = record(windowId))
+        allowedActions = rec->allowedActions;
+    else
+    {
+        // read the actions of an unmanaged window at once
+        KWindowInfo info(windowId, NET::Properties(), NET::WM2AllowedActions);
+        for (const NET::Action action : windowActions)
+        {
+            if (info.actionSupported(action))
+                allowedActions |= action;
+        }
+    }
+
+    int actions = 0;
+    for (int action = int(LXQtTaskBarBackendAction::Move); action <= int(LXQtTaskBarBackendAction::MoveToOutput); ++action)
+    {
+        const NET::Action x11Action = netAction(LXQtTaskBarBackendAction(action));
+        if (x11Action == 0 || allowedActions.testFlag(x11Action))
+            actions |= backendActionBit(LXQtTaskBarBackendAction(action));
+    }
+    return actions;
+}
+
 bool LXQtWMBackendX11::reloadWindows()
 {
     QVector<WId> knownWindows;
     qSwap(knownWindows, m_windows);
+    m_records.clear();
+    m_windowIcons.clear();
+    m_sharedIcons.clear();
     QList<WId> new_list;
 
     // Just add new windows to groups, deleting is up to the groups
-    const auto wnds = KX11Extras::stackingOrder();
+    const auto wnds = fetchWindows(KX11Extras::stackingOrder());
     for (auto const wnd: wnds)
     {
-        if (acceptWindow(wnd))
-        {
-            new_list << wnd;
-            addWindow_internal(wnd);
-        }
+        new_list << wnd;
+        addWindow_internal(wnd);
     }
 
     //emulate windowRemoved if known window not reported by KWindowSystem
@@ -299,6 +831,9 @@ QVector<WId> LXQtWMBackendX11::getCurrentWindows() const
 
 QString LXQtWMBackendX11::getWindowTitle(WId windowId) const
 {
+    if (const WindowRecord *rec = record(windowId))
+        return rec->title;
+
     KWindowInfo info(windowId, NET::WMVisibleName | NET::WMName);
     QString title = info.visibleName().isEmpty() ? info.name() : info.visibleName();
     return title;
@@ -306,6 +841,9 @@ QString LXQtWMBackendX11::getWindowTitle(WId windowId) const
 
 bool LXQtWMBackendX11::applicationDemandsAttention(WId windowId) const
 {
+    if (const WindowRecord *rec = record(windowId))
+        return rec->urgency || rec->state.testFlag(NET::DemandsAttention);
+
     WId appRootWindow = XDefaultRootWindow(m_X11Display);
     return NETWinInfo(m_xcbConnection, windowId, appRootWindow, NET::Properties{}, NET::WM2Urgency).urgency()
            || KWindowInfo{windowId, NET::WMState}.hasState(NET::DemandsAttention);
@@ -313,18 +851,62 @@ bool LXQtWMBackendX11::applicationDemandsAttention(WId windowId) const
 
 QIcon LXQtWMBackendX11::getApplicationIcon(WId windowId, int devicePixels) const
 {
-    return KX11Extras::icon(windowId, devicePixels, devicePixels);
+    // don't keep the icons of windows we won't hear about anymore
+    if (!m_records.contains(windowId))
+        return KX11Extras::icon(windowId, devicePixels, devicePixels);
+
+    QHash<int, QByteArray> &sizes = m_windowIcons[windowId];
+    auto cached = sizes.constFind(devicePixels);
+    if (cached != sizes.cend())
+        return cached->isEmpty() ? QIcon() : m_sharedIcons.value(*cached).icon;
+
+    const QPixmap pixmap = KX11Extras::icon(windowId, devicePixels, devicePixels);
+    if (pixmap.isNull())
+    {
+        sizes.insert(devicePixels, QByteArray());
+        return QIcon();
+    }
+
+    const QImage image = pixmap.toImage();
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(&devicePixels), sizeof(devicePixels)));
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(image.constBits()), image.sizeInBytes()));
+    const QByteArray digest = hash.result();
+
+    SharedIcon &shared = m_sharedIcons[digest];
+    if (shared.users == 0)
+        shared.icon = QIcon(pixmap);
+    ++shared.users;
+    sizes.insert(devicePixels, digest);
+    return shared.icon;
+}
+
+void LXQtWMBackendX11::dropIcons(WId windowId) const
+{
+    const QHash<int, QByteArray> sizes = m_windowIcons.take(windowId);
+    for (const QByteArray &digest : sizes)
+    {
+        if (digest.isEmpty())
+            continue;
+        auto shared = m_sharedIcons.find(digest);
+        if (shared != m_sharedIcons.end() && --shared->users == 0)
+            m_sharedIcons.erase(shared);
+    }
 }
 
 QString LXQtWMBackendX11::getWindowClass(WId windowId) const
 {
+    if (const WindowRecord *rec = record(windowId))
+        return rec->windowClass;
+
     KWindowInfo info(windowId, NET::Properties(), NET::WM2WindowClass);
     return QString::fromUtf8(info.windowClassClass());
 }
 
 LXQtTaskBarWindowLayer LXQtWMBackendX11::getWindowLayer(WId windowId) const
 {
-    NET::States state = KWindowInfo(windowId, NET::WMState).state();
+    const WindowRecord *rec = record(windowId);
+    NET::States state = rec ? rec->state : KWindowInfo(windowId, NET::WMState).state();
     if(state.testFlag(NET::KeepAbove))
         return LXQtTaskBarWindowLayer::KeepAbove;
     else if(state.testFlag(NET::KeepBelow))
@@ -357,11 +939,21 @@ bool LXQtWMBackendX11::setWindowLayer(WId windowId, LXQtTaskBarWindowLayer layer
 
 LXQtTaskBarWindowState LXQtWMBackendX11::getWindowState(WId windowId) const
 {
-    KWindowInfo info(windowId, NET::WMState | NET::XAWMState);
-    if(info.isMinimized())
-        return LXQtTaskBarWindowState::Minimized;
+    NET::States state;
+    if (const WindowRecord *rec = record(windowId))
+    {
+        if(rec->minimized)
+            return LXQtTaskBarWindowState::Minimized;
+        state = rec->state;
+    }
+    else
+    {
+        KWindowInfo info(windowId, NET::WMState | NET::XAWMState);
+        if(info.isMinimized())
+            return LXQtTaskBarWindowState::Minimized;
+        state = info.state();
+    }
 
-    NET::States state = info.state();
     if(state.testFlag(NET::Hidden))
         return LXQtTaskBarWindowState::Hidden;
     if(state.testFlag(NET::Max))
@@ -468,6 +1060,23 @@ WId LXQtWMBackendX11::getActiveWindow() const
     return KX11Extras::activeWindow();
 }
 
+LXQtTaskBarWindowSnapshot LXQtWMBackendX11::getWindowSnapshot(WId windowId) const
+{
+    // unmanaged windows are read from the server
+    const WindowRecord *rec = record(windowId);
+    if (!rec)
+        return ILXQtAbstractWMInterface::getWindowSnapshot(windowId);
+
+    LXQtTaskBarWindowSnapshot snapshot;
+    snapshot.title = rec->title;
+    snapshot.windowClass = rec->windowClass;
+    snapshot.state = getWindowState(windowId);
+    snapshot.workspace = rec->desktop;
+    snapshot.geometry = rec->frameGeometry;
+    snapshot.demandsAttention = rec->urgency || rec->state.testFlag(NET::DemandsAttention);
+    return snapshot;
+}
+
 
 /************************************************
  *   Workspaces
@@ -498,6 +1107,9 @@ bool LXQtWMBackendX11::setCurrentWorkspace(int idx)
 
 int LXQtWMBackendX11::getWindowWorkspace(WId windowId) const
 {
+    if (const WindowRecord *rec = record(windowId))
+        return rec->desktop;
+
     KWindowInfo info(windowId, NET::WMDesktop);
     return info.desktop();
 }
@@ -567,7 +1179,8 @@ bool LXQtWMBackendX11::isWindowOnScreen(QScreen *screen, WId windowId) const
     if(!screen)
         return true;
 
-    QRect r = KWindowInfo(windowId, NET::WMFrameExtents).frameGeometry();
+    const WindowRecord *rec = record(windowId);
+    QRect r = rec ? rec->frameGeometry : KWindowInfo(windowId, NET::WMFrameExtents).frameGeometry();
     return screen->geometry().intersects(r);
 }
 
@@ -633,24 +1246,16 @@ void LXQtWMBackendX11::refreshIconGeometry(WId windowId, QRect const & geom)
 {
     // NOTE: This function announces where the task icon is,
     // such that X11 WMs can perform their related animations correctly.
+    // The taskbar only calls it for changed rects, so the current value is
+    // not read back: the property is just written, without a round trip.
 
     WId appRootWindow = XDefaultRootWindow(m_X11Display);
 
     NETWinInfo info(m_xcbConnection,
                     windowId,
                     appRootWindow,
-                    NET::WMIconGeometry,
+                    NET::Properties(),
                     NET::Properties2());
-    NETRect const curr = info.iconGeometry();
-
-    // see kwindowsystem -> NETWinInfo::setIconGeometry for the scale factor
-    const qreal scaleFactor = qApp->devicePixelRatio();
-    int xPos = geom.x() * scaleFactor;
-    int yPos = geom.y() * scaleFactor;
-    int w = geom.width() * scaleFactor;
-    int h = geom.height() * scaleFactor;
-    if (xPos == curr.pos.x && yPos == curr.pos.y && w == curr.size.width && h == curr.size.height)
-        return;
     NETRect nrect;
     nrect.pos.x = geom.x();
     nrect.pos.y = geom.y();
@@ -661,30 +1266,23 @@ void LXQtWMBackendX11::refreshIconGeometry(WId windowId, QRect const & geom)
 
 bool LXQtWMBackendX11::isAreaOverlapped(const QRect &area) const
 {
-    //TODO: reuse our m_windows cache?
-    QFlags<NET::WindowTypeMask> ignoreList;
-    ignoreList |= NET::DesktopMask;
-    ignoreList |= NET::DockMask;
-    ignoreList |= NET::SplashMask;
-    ignoreList |= NET::MenuMask;
-    ignoreList |= NET::PopupMenuMask;
-    ignoreList |= NET::DropdownMenuMask;
-    ignoreList |= NET::TopMenuMask;
-    ignoreList |= NET::NotificationMask;
+    if (!m_overlapTracked)
+    {
+        m_overlapTracked = true;
+        const auto wIds = KX11Extras::stackingOrder();
+        for (auto const wId : wIds)
+            trackOverlap(wId);
+    }
 
-    const auto wIds = KX11Extras::stackingOrder();
-    for (auto const wId : wIds)
-    {
-        KWindowInfo info(wId, NET::WMWindowType | NET::WMState | NET::WMFrameExtents | NET::WMDesktop);
-        if (info.valid()
-            // skip windows that are on other desktops
-            && info.isOnCurrentDesktop()
-            // skip shaded, minimized or hidden windows
-            && !(info.state() & (NET::Shaded | NET::Hidden))
-            // check against the list of ignored types
-            && !NET::typeMatchesMask(info.windowType(NET::AllTypesMask), ignoreList))
+    // only the windows on the current desktop and on all desktops are checked
+    for (const int desktop : {KX11Extras::currentDesktop(), int(NET::OnAllDesktops)})
+    {
+        auto bucket = m_overlapBuckets.constFind(desktop);
+        if (bucket == m_overlapBuckets.cend())
+            continue;
+        for (const WId wId : *bucket)
         {
-            if (info.frameGeometry().intersects(area))
+            if (m_overlapWindows.value(wId).frame.intersects(area))
                 return true;
         }
     }
@@ -33,6 +33,11 @@
 
 #include <netwm_def.h>
 
+#include <QHash>
+#include <QIcon>
+#include <QRect>
+#include <QSet>
+
 typedef struct _XDisplay Display;
 struct xcb_connection_t;
 
@@ -45,6 +50,7 @@ public:
 
     // Backend
     virtual bool supportsAction(WId windowId, LXQtTaskBarBackendAction action) const override;
+    virtual int getSupportedActions(WId windowId) const override;
 
     // Windows
     virtual bool reloadWindows() override;
@@ -68,6 +74,8 @@ public:
 
     virtual WId getActiveWindow() const override;
 
+    virtual LXQtTaskBarWindowSnapshot getWindowSnapshot(WId windowId) const override;
+
     // Workspaces
     virtual int getWorkspacesCount() const override;
     virtual QString getWorkspaceName(int idx) const override;
@@ -107,18 +115,101 @@ private slots:
 private:
     bool acceptWindow(WId windowId) const;
     void addWindow_internal(WId windowId);
+    void removeWindow_internal(WId windowId);
+
+    void trackOverlap(WId windowId) const;
+    void untrackOverlap(WId windowId) const;
+
+    /*
+     * Cached properties of a window in m_windows. The record is filled when
+     * the window is accepted and then only the properties reported as
+     * changed by KX11Extras::windowChanged are fetched again, so that the
+     * getters don't need to ask the X server.
+     */
+    struct WindowRecord
+    {
+        QString title;
+        QString windowClass;
+        NET::States state;
+        bool minimized = false;
+        bool urgency = false; //!< from WM_HINTS, NET::DemandsAttention is in state
+        int desktop = 0;
+        QRect frameGeometry;
+        NET::Actions allowedActions;
+    };
+    void updateRecord(WindowRecord &record, WId windowId, NET::Properties prop, NET::Properties2 prop2) const;
+    const WindowRecord *record(WId windowId) const;
+
+    /*
+     * Bulk enumeration: returns the accepted windows among the given ones
+     * and fills their records. All the requests for all the windows are sent
+     * before the first reply is read, so that the enumeration costs about two
+     * round trips instead of several per window.
+     */
+    QVector<WId> fetchWindows(const QList<WId> &windows);
+    void internFetchAtoms();
+
+    struct FetchAtoms
+    {
+        quint32 windowType = 0;
+        quint32 state = 0;
+        quint32 name = 0;
+        quint32 visibleName = 0;
+        quint32 utf8String = 0;
+        quint32 wmState = 0;
+        quint32 desktop = 0;
+        quint32 frameExtents = 0;
+        quint32 allowedActions = 0;
+        QHash<quint32, int> types; //!< atom -> NET::WindowType
+        QHash<quint32, int> states; //!< atom -> NET::State
+        QHash<quint32, int> actions; //!< atom -> NET::Action
+    };
+    FetchAtoms m_fetchAtoms;
+    bool m_fetchAtomsInterned = false;
+
+    /*
+     * Decoded icons of the managed windows, per requested size. They are
+     * dropped when the icon or the class of the window changes. Identical
+     * icons (e.g. of the windows of one application) are stored once, keyed
+     * by a hash of their content.
+     */
+    struct SharedIcon
+    {
+        QIcon icon;
+        int users = 0;
+    };
+    mutable QHash<WId, QHash<int, QByteArray>> m_windowIcons; //!< window -> size -> content hash
+    mutable QHash<QByteArray, SharedIcon> m_sharedIcons;
+    void dropIcons(WId windowId) const;
 
 private:
     Display *m_X11Display;
     xcb_connection_t *m_xcbConnection;
 
     QVector<WId> m_windows;
+    QHash<WId, WindowRecord> m_records;
+
+    /*
+     * Overlap tracker used by isAreaOverlapped(). It holds the frame geometry
+     * of all the windows which can cover the panel, bucketed by workspace
+     * (NET::OnAllDesktops included), and is updated on window events, so that
+     * a check does not query every window from the X server.
+     * It is filled on the first check, the panel may never ask.
+     */
+    struct OverlapWindow
+    {
+        QRect frame;
+        int desktop = 0;
+    };
+    mutable bool m_overlapTracked = false;
+    mutable QHash<WId, OverlapWindow> m_overlapWindows;
+    mutable QHash<int, QSet<WId>> m_overlapBuckets;
 };
 
 class LXQtWMBackendX11Library: public QObject, public ILXQtWMBackendLibrary
 {
     Q_OBJECT
-    Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0")
+    Q_PLUGIN_METADATA(IID "lxqt.org/Panel/WMInterface/1.0" FILE "lxqtwmbackend_x11.json")
     Q_INTERFACES(ILXQtWMBackendLibrary)
 public:
     int getBackendScore(const QString& key) const override;
@@ -29,10 +29,10 @@
 #include "addplugindialog.h"
 #include "plugin.h"
 #include "../lxqtpanelapplication.h"
+#include "../plugininfoindex.h"
 
 #include <LXQt/HtmlDelegate>
 #include <XdgIcon>
-#include <XdgDirs>
 
 #include <QString>
 #include <QLineEdit>
@@ -48,12 +48,7 @@ AddPluginDialog::AddPluginDialog(QWidget *parent):
 {
     ui->setupUi(this);
 
-    QStringList desktopFilesDirs;
-    desktopFilesDirs << QString::fromLocal8Bit(qgetenv("LXQT_PANEL_PLUGINS_DIR")).split(QLatin1Char(':'), Qt::SkipEmptyParts);
-    desktopFilesDirs << QStringLiteral("%1/%2").arg(XdgDirs::dataHome(), QStringLiteral("/lxqt/lxqt-panel"));
-    desktopFilesDirs << QStringLiteral(PLUGIN_DESKTOPS_DIR);
-
-    mPlugins = LXQt::PluginInfo::search(desktopFilesDirs, QLatin1String("LXQtPanel/Plugin"), QLatin1String("*"));
+    mPlugins = PluginInfoIndex::instance()->all(PluginInfoIndex::desktopDirs());
     std::sort(mPlugins.begin(), mPlugins.end(), [](const LXQt::PluginInfo &p1, const LXQt::PluginInfo &p2) {
         return p1.name() < p2.name() || (p1.name() == p2.name() && p1.comment() < p2.comment());
     });
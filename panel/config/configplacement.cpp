@@ -237,6 +237,7 @@ ConfigPlacement::~ConfigPlacement()
  ************************************************/
 void ConfigPlacement::editChanged()
 {
+    mPanel->beginSettingsTransaction();
     mPanel->setPanelSize(ui->spinBox_panelSize->value(), true);
     mPanel->setIconSize(ui->spinBox_iconSize->value(), true);
     mPanel->setLineCount(ui->spinBox_lineCount->value(), true);
@@ -257,6 +258,7 @@ void ConfigPlacement::editChanged()
     mPanel->setHideOnOverlap(ui->checkBox_overlap->isChecked(), true);
     mPanel->setAnimationTime(ui->spinBox_animation->value(), true);
     mPanel->setShowDelay(ui->spinBox_delay->value(), true);
+    mPanel->commitSettingsTransaction();
 }
 
 
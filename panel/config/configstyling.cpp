@@ -158,6 +158,7 @@ ConfigStyling::~ConfigStyling()
  ************************************************/
 void ConfigStyling::editChanged()
 {
+    mPanel->beginSettingsTransaction();
     mPanel->setFontColor(ui->checkBox_customFontColor->isChecked() ? mFontColor : QColor(), true);
     if (ui->checkBox_customBgColor->isChecked())
     {
@@ -177,6 +178,7 @@ void ConfigStyling::editChanged()
         mPanel->setIconTheme(QString());
     else if (!ui->comboBox_icon->currentText().isEmpty())
         mPanel->setIconTheme(ui->comboBox_icon->currentText());
+    mPanel->commitSettingsTransaction();
 }
 
 
@@ -31,10 +31,12 @@
 #include "ilxqtpanelplugin.h"
 #include "lxqtpanelapplication.h"
 #include "lxqtpanellayout.h"
+#include "lxqtpanelprofiler.h"
 #include "config/configpaneldialog.h"
 #include "popupmenu.h"
 #include "plugin.h"
 #include "panelpluginsmodel.h"
+#include "plugininfoindex.h"
 #include "windownotifier.h"
 #include <LXQt/PluginInfo>
 
@@ -47,24 +49,53 @@
 #include <QDropEvent>
 #include <QPainter>
 #include <XdgIcon>
-#include <XdgDirs>
 
 #include <KWindowSystem>
 #include <KX11Extras>
 #include <NETWM>
 
 #include <algorithm>
+#include <utility>
 
 #include "backends/ilxqtabstractwmiface.h"
 
 
 #include <LayerShellQt/Window>
 
-// Turn on this to show the time required to load each plugin during startup
-// #define DEBUG_PLUGIN_LOADTIME
-#ifdef DEBUG_PLUGIN_LOADTIME
-#include <QElapsedTimer>
-#endif
+/************************************************
+ Paints a plain color. The color is kept in a member rather than in the
+ palette, because the style sheet engine restores the palettes it saved
+ whenever the widgets are repolished.
+ ************************************************/
+class BackgroundFill : public QWidget
+{
+public:
+    explicit BackgroundFill(QWidget *parent = nullptr) :
+        QWidget(parent)
+    {
+        setAttribute(Qt::WA_TransparentForMouseEvents);
+    }
+
+    void setColor(const QColor &color)
+    {
+        if (color == mColor)
+            return;
+        mColor = color;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent * /*event*/) override
+    {
+        if (mColor.alpha() == 0)
+            return;
+        QPainter painter(this);
+        painter.fillRect(rect(), mColor);
+    }
+
+private:
+    QColor mColor = Qt::transparent;
+};
 
 // Config keys and groups
 #define CFG_KEY_SCREENNUM          "desktop"
@@ -87,6 +118,7 @@
 #define CFG_KEY_ANIMATION          "animation-duration"
 #define CFG_KEY_SHOW_DELAY         "show-delay"
 #define CFG_KEY_LOCKPANEL          "lockPanel"
+#define CFG_KEY_STAGED_LOADING     "staged-plugin-loading"
 
 /************************************************
  Returns the Position by the string.
@@ -151,7 +183,12 @@ LXQtPanel::LXQtPanel(const QString &configGroup, LXQt::Settings *settings, QWidg
     mAnimation(nullptr),
     mWAnimation(nullptr),
     mLayerWindow(nullptr),
-    mLockPanel(false)
+    mLockPanel(false),
+    mStagedPluginLoading(false),
+    mSettingsTransactions(0),
+    mPendingStyleSheet(false),
+    mPendingRealign(false),
+    mPendingSave(false)
 {
     //You can find information about the flags and widget attributes in your
     //Qt documentation or at https://doc.qt.io/qt-5/qt.html
@@ -185,12 +222,17 @@ LXQtPanel::LXQtPanel(const QString &configGroup, LXQt::Settings *settings, QWidg
     setObjectName(QStringLiteral("LXQtPanel %1").arg(configGroup));
 
     //LXQtPanel (inherits QFrame) -> lav (QGridLayout) -> LXQtPanelWidget (QFrame) -> LXQtPanelLayout
+    //The background color is painted by mBackgroundFill, which shares the
+    //grid cell with LXQtPanelWidget and lies below it.
+    mBackgroundFill = new BackgroundFill(this);
+    mBackgroundFill->setObjectName(QStringLiteral("BackgroundFill"));
     LXQtPanelWidget = new QFrame(this);
     LXQtPanelWidget->setObjectName(QStringLiteral("BackgroundWidget"));
     QGridLayout* lav = new QGridLayout();
     lav->setContentsMargins(0, 0, 0, 0);
     setLayout(lav);
-    this->layout()->addWidget(LXQtPanelWidget);
+    lav->addWidget(mBackgroundFill, 0, 0);
+    lav->addWidget(LXQtPanelWidget, 0, 0);
 
     mLayout = new LXQtPanelLayout(LXQtPanelWidget);
     connect(mLayout, &LXQtPanelLayout::pluginMoved, this, &LXQtPanel::pluginMoved);
@@ -324,15 +366,15 @@ LXQtPanel::LXQtPanel(const QString &configGroup, LXQt::Settings *settings, QWidg
                 mShowDelayTimer.stop(); // workspace may be changed and restored quickly
        }
     });
-    connect(wmBackend, &ILXQtAbstractWMInterface::windowPropertyChanged,
-            this, [this] (WId /* id */, int prop)
+    connect(wmBackend, &ILXQtAbstractWMInterface::windowPropertiesChanged,
+            this, [this] (WId /* id */, int props)
     {
         if (mHidable && mHideOnOverlap
             // when a window is moved, resized, shaded, or minimized
-            && (prop == int(LXQtTaskBarWindowProperty::Geometry)
-                || prop == int(LXQtTaskBarWindowProperty::State)
+            && (props & (windowPropertyBit(LXQtTaskBarWindowProperty::Geometry)
+                         | windowPropertyBit(LXQtTaskBarWindowProperty::State))
                 // on Wayland, workspace change is not seen as geometry change
-                || (mLayerWindow && prop == int(LXQtTaskBarWindowProperty::Workspace))))
+                || (mLayerWindow && (props & windowPropertyBit(LXQtTaskBarWindowProperty::Workspace)))))
         {
             if (!mHidden)
             {
@@ -352,6 +394,9 @@ LXQtPanel::LXQtPanel(const QString &configGroup, LXQt::Settings *settings, QWidg
  ************************************************/
 void LXQtPanel::readSettings()
 {
+    LXQtPanelProfileScope profile(QStringLiteral("readSettings"), QStringLiteral("settings"),
+                                  {{QStringLiteral("panel"), mConfigGroup}});
+
     // Read settings ......................................
     mSettings->beginGroup(mConfigGroup);
 
@@ -428,6 +473,8 @@ void LXQtPanel::readSettings()
 
     mLockPanel = mSettings->value(QStringLiteral(CFG_KEY_LOCKPANEL), false).toBool();
 
+    mStagedPluginLoading = mSettings->value(QStringLiteral(CFG_KEY_STAGED_LOADING), false).toBool();
+
     mSettings->endGroup();
 }
 
@@ -437,6 +484,12 @@ void LXQtPanel::readSettings()
  ************************************************/
 void LXQtPanel::saveSettings(bool later)
 {
+    if (mSettingsTransactions > 0)
+    {
+        mPendingSave = true;
+        return;
+    }
+
     mDelaySave.stop();
     if (later)
     {
@@ -485,10 +538,38 @@ void LXQtPanel::saveSettings(bool later)
 
     mSettings->setValue(QStringLiteral(CFG_KEY_LOCKPANEL), mLockPanel);
 
+    mSettings->setValue(QStringLiteral(CFG_KEY_STAGED_LOADING), mStagedPluginLoading);
+
     mSettings->endGroup();
 }
 
 
+/************************************************
+
+ ************************************************/
+void LXQtPanel::beginSettingsTransaction()
+{
+    ++mSettingsTransactions;
+}
+
+
+/************************************************
+
+ ************************************************/
+void LXQtPanel::commitSettingsTransaction()
+{
+    if (mSettingsTransactions == 0 || --mSettingsTransactions > 0)
+        return;
+
+    if (std::exchange(mPendingStyleSheet, false))
+        updateStyleSheet();
+    if (std::exchange(mPendingRealign, false))
+        realign();
+    if (std::exchange(mPendingSave, false))
+        saveSettings(true);
+}
+
+
 /************************************************
 
  ************************************************/
@@ -551,28 +632,18 @@ void LXQtPanel::show()
 }
 
 
-/************************************************
-
- ************************************************/
-QStringList pluginDesktopDirs()
-{
-    QStringList dirs;
-    dirs << QString::fromLocal8Bit(qgetenv("LXQT_PANEL_PLUGINS_DIR")).split(QLatin1Char(':'), Qt::SkipEmptyParts);
-    dirs << QStringLiteral("%1/%2").arg(XdgDirs::dataHome(), QStringLiteral("/lxqt/lxqt-panel"));
-    dirs << QStringLiteral(PLUGIN_DESKTOPS_DIR);
-    return dirs;
-}
-
-
 /************************************************
 
  ************************************************/
 void LXQtPanel::loadPlugins()
 {
+    LXQtPanelProfileScope profile(QStringLiteral("loadPlugins"), QStringLiteral("panel"),
+                                  {{QStringLiteral("panel"), mConfigGroup}});
+
     QString names_key(mConfigGroup);
     names_key += QLatin1Char('/');
     names_key += QLatin1String(CFG_KEY_PLUGINS);
-    mPlugins.reset(new PanelPluginsModel(this, names_key, pluginDesktopDirs()));
+    mPlugins.reset(new PanelPluginsModel(this, names_key, PluginInfoIndex::desktopDirs(), mStagedPluginLoading));
 
     connect(mPlugins.get(), &PanelPluginsModel::pluginAdded, mLayout, &LXQtPanelLayout::addPlugin);
     connect(mPlugins.get(), &PanelPluginsModel::pluginMovedUp, mLayout, &LXQtPanelLayout::moveUpPlugin);
@@ -580,14 +651,36 @@ void LXQtPanel::loadPlugins()
     connect(mPlugins.get(), &PanelPluginsModel::pluginAdded, this, &LXQtPanel::pluginAdded);
     connect(mPlugins.get(), &PanelPluginsModel::pluginRemoved, this, &LXQtPanel::pluginRemoved);
 
-    const auto plugins = mPlugins->plugins();
-    for (auto const & plugin : plugins)
-    {
-        mLayout->addPlugin(plugin);
+    auto watchDragLeft = [this] (Plugin * plugin) {
         connect(plugin, &Plugin::dragLeft, this, [this] {
             mShowDelayTimer.stop();
             hidePanel();
         });
+    };
+
+    connect(mPlugins.get(), &PanelPluginsModel::deferredPluginLoaded, this,
+            [this, watchDragLeft] (Plugin * plugin, PluginPlaceholder * placeholder) {
+        mLayout->replacePlaceholder(placeholder, plugin);
+        if (plugin)
+        {
+            watchDragLeft(plugin);
+            emit pluginAdded();
+        }
+    });
+
+    // deferred plugins are represented by their placeholders until they are loaded
+    const auto names = mPlugins->pluginNames();
+    for (auto const & name : names)
+    {
+        if (Plugin * plugin = mPlugins->pluginByName(name))
+        {
+            mLayout->addPlugin(plugin);
+            watchDragLeft(plugin);
+        }
+        else if (PluginPlaceholder * placeholder = mPlugins->placeholder(name))
+        {
+            mLayout->addWidget(placeholder);
+        }
     }
 }
 
@@ -786,7 +879,10 @@ void LXQtPanel::setPanelGeometry(bool animate)
                         setMargins();
                         // "setWindowOpacity()" does not work on Wayland
                         if (!mVisibleMargin)
+                        {
                             LXQtPanelWidget->setVisible(false);
+                            mBackgroundFill->setVisible(false);
+                        }
                     }
                 });
                 connect(mWAnimation, &QVariantAnimation::valueChanged, this,
@@ -804,14 +900,20 @@ void LXQtPanel::setPanelGeometry(bool animate)
             {
                 setMargins();
                 if (!mVisibleMargin)
+                {
+                    mBackgroundFill->setVisible(true);
                     LXQtPanelWidget->setVisible(true);
+                }
             }
             mWAnimation->start();
         }
         else
         {
             if (!mVisibleMargin)
+            {
+                mBackgroundFill->setVisible(!mHidden);
                 LXQtPanelWidget->setVisible(!mHidden);
+            }
             setMargins();
             mLayerWindow->setMargins(layerWindowMargins());
             windowHandle()->requestUpdate();
@@ -875,6 +977,12 @@ void LXQtPanel::setMargins()
 
 void LXQtPanel::realign()
 {
+    if (mSettingsTransactions > 0)
+    {
+        mPendingRealign = true;
+        return;
+    }
+
     if (!isVisible())
         return;
 #if 0
@@ -1140,10 +1248,23 @@ void LXQtPanel::showAddPluginDialog()
  ************************************************/
 void LXQtPanel::updateStyleSheet()
 {
-    // NOTE: This is a workaround for Qt >= 5.13, which might not completely
-    // update the style sheet (especially positioned backgrounds of plugins
-    // with NeedsHandle="true") if it is not reset first.
-    setStyleSheet(QString());
+    if (mSettingsTransactions > 0)
+    {
+        mPendingStyleSheet = true;
+        return;
+    }
+
+    // The background color and opacity are only painted by mBackgroundFill.
+    // Style sheet rules are reapplied only when their text changes, because
+    // that repolishes every widget in the panel.
+    if (mBackgroundColor.isValid())
+    {
+        QColor color = mBackgroundColor;
+        color.setAlphaF(static_cast<float>(mOpacity) / 100);
+        mBackgroundFill->setColor(color);
+    }
+    else
+        mBackgroundFill->setColor(Qt::transparent);
 
     QStringList sheet;
     sheet << QStringLiteral("Plugin > QAbstractButton, LXQtTray { qproperty-iconSize: %1px %1px; }").arg(mIconSize);
@@ -1152,20 +1273,23 @@ void LXQtPanel::updateStyleSheet()
     if (mFontColor.isValid())
         sheet << QString(QStringLiteral("Plugin * { color: ") + mFontColor.name() + QStringLiteral("; }"));
 
+    // the color of the theme is replaced by the one painted by mBackgroundFill
     if (mBackgroundColor.isValid())
-    {
-        QString color = QStringLiteral("%1, %2, %3, %4")
-            .arg(mBackgroundColor.red())
-            .arg(mBackgroundColor.green())
-            .arg(mBackgroundColor.blue())
-            .arg((float) mOpacity / 100);
-        sheet << QString(QStringLiteral("LXQtPanel #BackgroundWidget { background-color: rgba(") + color + QStringLiteral("); }"));
-    }
+        sheet << QStringLiteral("LXQtPanel #BackgroundWidget { background-color: transparent; }");
 
     if (QFileInfo::exists(mBackgroundImage))
         sheet << QString(QStringLiteral("LXQtPanel #BackgroundWidget { background-image: url('") + mBackgroundImage + QStringLiteral("');}"));
 
-    setStyleSheet(sheet.join(QStringLiteral("\n")));
+    const QString styleSheet = sheet.join(QStringLiteral("\n"));
+    if (styleSheet == mStyleSheet)
+        return;
+    mStyleSheet = styleSheet;
+
+    // NOTE: This is a workaround for Qt >= 5.13, which might not completely
+    // update the style sheet (especially positioned backgrounds of plugins
+    // with NeedsHandle="true") if it is not reset first.
+    setStyleSheet(QString());
+    setStyleSheet(mStyleSheet);
 }
 
 
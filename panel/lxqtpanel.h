@@ -56,6 +56,7 @@ class LXQtPanelLayout;
 class ConfigPanelDialog;
 class PanelPluginsModel;
 class WindowNotifier;
+class BackgroundFill;
 
 /*! \brief The LXQtPanel class provides a single lxqt-panel. All LXQtPanel
  * instances should be created and handled by LXQtPanelApplication. In turn,
@@ -329,6 +330,14 @@ public slots:
      * later==false, settings will be written.
      */
     void saveSettings(bool later=false);
+    /**
+     * @brief Starts collecting settings changes. Until the matching
+     * commitSettingsTransaction(), the setters only store the new values;
+     * the panel is then restyled, realigned and saved once, instead of once
+     * per setter. Transactions may be nested.
+     */
+    void beginSettingsTransaction();
+    void commitSettingsTransaction(); //!< \sa beginSettingsTransaction()
     /**
      * @brief Checks if the panel can be placed on the current screen at the
      * current position. If it can not, it will be moved on another screen
@@ -463,11 +472,18 @@ private:
     LXQt::Settings *mSettings;
     /**
      * @brief The background widget for the panel. This background widget will
-     * have the background color or the background image if any of these is
-     * set. This background widget will have the LXQtPanelLayout mLayout which
-     * will in turn contain all the Plugins.
+     * have the background image if it is set. This background widget will
+     * have the LXQtPanelLayout mLayout which will in turn contain all the
+     * Plugins.
      */
     QFrame *LXQtPanelWidget;
+    /**
+     * @brief Paints the background color, with the opacity applied, below
+     * LXQtPanelWidget. The color is painted directly instead of being set in
+     * the style sheet, so that changing the color or the opacity does not
+     * repolish the plugins.
+     */
+    BackgroundFill *mBackgroundFill;
     /**
      * @brief The name of the panel which will also be used as an identifier
      * for config files.
@@ -692,7 +708,7 @@ private:
     QTimer mShowDelayTimer;
 
     QColor mFontColor; //!< Font color that is used in the style sheet.
-    QColor mBackgroundColor; //!< Background color that is used in the style sheet.
+    QColor mBackgroundColor; //!< Background color, painted by mBackgroundFill.
     QString mBackgroundImage; //!< Background image that is used in the style sheet.
     /**
      * @brief Determines the opacity of the background color. The value
@@ -728,12 +744,29 @@ private:
      */
     bool mLockPanel;
 
+    /**
+     * @brief Flag for loading the plugins which are not needed for a usable
+     * panel after the panel is shown (see PanelPluginsModel).
+     */
+    bool mStagedPluginLoading;
+
+    /**
+     * @brief Nesting level of beginSettingsTransaction() and the work
+     * postponed until the outermost commitSettingsTransaction().
+     */
+    int mSettingsTransactions;
+    bool mPendingStyleSheet;
+    bool mPendingRealign;
+    bool mPendingSave;
+
     /**
      * @brief Updates the style sheet for the panel. First, the stylesheet is
      * created from the preferences. Then, it is set via
-     * QWidget::setStyleSheet().
+     * QWidget::setStyleSheet() if it differs from mStyleSheet. The background
+     * color is passed to mBackgroundFill.
      */
     void updateStyleSheet();
+    QString mStyleSheet; //!< The style sheet last set by updateStyleSheet().
 
     /**
      * @brief Checks if the panel overlaps a window.
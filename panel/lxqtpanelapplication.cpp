@@ -30,6 +30,7 @@
 
 #include "config/configpaneldialog.h"
 #include "lxqtpanel.h"
+#include "lxqtpanelprofiler.h"
 
 #include <QCommandLineParser>
 #include <QScreen>
@@ -40,17 +41,30 @@
 
 #include <QPluginLoader>
 #include <QDir>
+#include <QJsonArray>
+#include <QJsonObject>
 #include <QProcessEnvironment>
 
 #include "backends/lxqtdummywmbackend.h"
 
-static inline QMap<QString, int> getBackendScoreMap( QString compositor )
+#define WM_BACKEND_IID "lxqt.org/Panel/WMInterface/1.0"
+
+struct BackendInfo
+{
+    QString fileName;
+    QString filePath;
+    QJsonObject metaData;
+};
+
+static inline QList<BackendInfo> getBackends()
 {
+    LXQtPanelProfileScope profile(QStringLiteral("getBackends"), QStringLiteral("backend"));
+
     QStringList dirs;
     dirs << QProcessEnvironment::systemEnvironment().value(QStringLiteral("LXQTPANEL_PLUGIN_PATH")).split(QStringLiteral(":"));
     dirs << QStringLiteral(PLUGIN_DIR);
 
-    QMap<QString, int> backendScoreMap;
+    QList<BackendInfo> backends;
 
     for(const QString& dir : std::as_const(dirs))
     {
@@ -60,26 +74,81 @@ static inline QMap<QString, int> getBackendScoreMap( QString compositor )
         }
 
         const auto entryList = backendsDir.entryInfoList(QStringList() << QStringLiteral("*.so"), QDir::Files|QDir::System|QDir::Readable);
-        for(QFileInfo info: entryList)
+        for(const QFileInfo& info: entryList)
         {
+            // The metadata is read from the file without loading the library
             QPluginLoader loader(info.absoluteFilePath());
-            if(!loader.load())
-            {
-                QString err = loader.errorString();
-                qWarning() << "Backend error:" << err;
-            }
-
-            QObject *plugin = loader.instance();
-            if(!plugin)
+            const QJsonObject metaData = loader.metaData();
+            if (metaData.value(QLatin1String("IID")).toString() != QLatin1String(WM_BACKEND_IID))
                 continue;
 
-            ILXQtWMBackendLibrary *backend = qobject_cast<ILXQtWMBackendLibrary *>(plugin);
-            if(backend)
+            backends << BackendInfo{info.fileName(), info.absoluteFilePath(), metaData.value(QLatin1String("MetaData")).toObject()};
+        }
+    }
+
+    return backends;
+}
+
+static inline int getBackendScore( const BackendInfo& backendInfo, const QString& compositor )
+{
+    const QJsonObject& metaData = backendInfo.metaData;
+
+    if (metaData.contains(QLatin1String("environments")))
+    {
+        const QJsonArray platforms = metaData.value(QLatin1String("platforms")).toArray();
+        if (!platforms.isEmpty())
+        {
+            const QString platform = QGuiApplication::platformName();
+            bool supported = false;
+            for (const QJsonValue& value : platforms)
             {
-                backendScoreMap[ info.fileName() ] = backend->getBackendScore( compositor );
+                const QString name = value.toString();
+                // e.g. "wayland" also matches "wayland-egl"
+                if (platform == name || platform.startsWith(name + QLatin1Char('-')))
+                {
+                    supported = true;
+                    break;
+                }
             }
-            loader.unload();
+            if (!supported)
+                return 0;
         }
+
+        const QJsonObject environments = metaData.value(QLatin1String("environments")).toObject();
+        if (environments.contains(compositor))
+            return environments.value(compositor).toInt();
+        return environments.value(QLatin1String("*")).toInt();
+    }
+
+    // Backend without metadata, load it to get the score
+    QPluginLoader loader(backendInfo.filePath);
+    if(!loader.load())
+    {
+        qWarning() << "Backend error:" << loader.errorString();
+        return 0;
+    }
+
+    int score = 0;
+    ILXQtWMBackendLibrary *backend = qobject_cast<ILXQtWMBackendLibrary *>(loader.instance());
+    if(backend)
+    {
+        score = backend->getBackendScore( compositor );
+    }
+    loader.unload();
+
+    return score;
+}
+
+static inline QMap<QString, int> getBackendScoreMap( const QList<BackendInfo>& backends, const QString& compositor )
+{
+    LXQtPanelProfileScope profile(QStringLiteral("getBackendScoreMap"), QStringLiteral("backend"),
+                                  {{QStringLiteral("compositor"), compositor}});
+
+    QMap<QString, int> backendScoreMap;
+
+    for(const BackendInfo& backend : backends)
+    {
+        backendScoreMap[ backend.fileName ] = getBackendScore( backend, compositor );
     }
 
     return backendScoreMap;
@@ -126,30 +195,21 @@ static inline QString getBackendFilePath( QString name )
 static inline bool testBackend( QString backendName )
 {
     QString backendPath = getBackendFilePath( backendName );
-
-    QPluginLoader loader(backendPath);
-    if(!loader.load())
+    if (backendPath.isEmpty())
     {
-        qWarning() << "Backend error:" << loader.errorString();
+        qWarning() << "Backend error:" << backendName << "not found";
         return false;
     }
 
-    QObject *plugin = loader.instance();
-    if(!plugin) {
-        qWarning() << "Failed to create the plugin instance";
-        return false;
-    }
-
-    ILXQtWMBackendLibrary *backend = qobject_cast<ILXQtWMBackendLibrary *>(plugin);
-    bool okay = false;
-    if(backend)
+    // Only the metadata is checked here, the library is loaded once it is chosen
+    QPluginLoader loader(backendPath);
+    if (loader.metaData().value(QLatin1String("IID")).toString() != QLatin1String(WM_BACKEND_IID))
     {
-        okay = true;
+        qWarning() << "Backend error:" << backendPath << "is not a panel backend";
+        return false;
     }
 
-    loader.unload();
-
-    return okay;
+    return true;
 }
 
 LXQtPanelApplicationPrivate::LXQtPanelApplicationPrivate(LXQtPanelApplication *q)
@@ -200,8 +260,13 @@ void LXQtPanelApplicationPrivate::loadBackend()
      *    c. wayfire -> wayfire
      *    d. wayland -> wlroots
      *    e. other -> dummy
+     *
+     * The dummy backend can also be chosen explicitly as "<desktop>:dummy",
+     * which is used by lxqt-panel-bench.
      */
 
+    LXQtPanelProfileScope profile(QStringLiteral("loadBackend"), QStringLiteral("backend"));
+
     // Get and split XDG_CURRENT_DESKTOP.
     QStringList xdgCurrentDesktops = qEnvironmentVariable( "XDG_CURRENT_DESKTOP" ).split( QStringLiteral(":") );
 
@@ -225,7 +290,7 @@ void LXQtPanelApplicationPrivate::loadBackend()
                 continue;
             }
 
-			if ((parts[0] == xdgCurrentDesktop) && testBackend(parts[1]))
+			if ((parts[0] == xdgCurrentDesktop) && (parts[1] == QLatin1String("dummy") || testBackend(parts[1])))
 			{
 				preferredBackend = parts[1];
 				break;
@@ -245,16 +310,17 @@ void LXQtPanelApplicationPrivate::loadBackend()
         // It's wayland
         else {
             int bestScore = 0;
+            const QList<BackendInfo> backends = getBackends();
             for ( QString xdgCurrentDesktop: xdgCurrentDesktops )
         	{
-                QMap<QString, int> backendScoreMap = getBackendScoreMap( xdgCurrentDesktop );
+                QMap<QString, int> backendScoreMap = getBackendScoreMap( backends, xdgCurrentDesktop );
                 for( QString backend: backendScoreMap.keys() )
                 {
                     if ( backendScoreMap[ backend ] > bestScore )
                     {
                         bestScore = backendScoreMap[ backend ];
                         // No need to call testBackend().
-                        // We can be sure the plugin can be loaded.
+                        // We can be sure the plugin is a backend.
                         // Because we have a score.
                         preferredBackend = backend;
                     }
@@ -274,7 +340,11 @@ void LXQtPanelApplicationPrivate::loadBackend()
     // We now have the preferred backend.
     // We have taken into consideration, the user's choice.
     // In case it was unavailable, a default one has been chosen.
-    if(!preferredBackend.isEmpty())
+    if (preferredBackend == QLatin1String("dummy"))
+    {
+        mWMBackend = new LXQtDummyWMBackend;
+    }
+    else if(!preferredBackend.isEmpty())
     {
         loader.setFileName(getBackendFilePath(preferredBackend));
         if (loader.load())
@@ -299,6 +369,7 @@ void LXQtPanelApplicationPrivate::loadBackend()
 
     if(mWMBackend)
     {
+        profile.setArgument(QStringLiteral("backend"), preferredBackend);
         qDebug() << "\nPanel backend:" << preferredBackend << "\n";
     }
     else
@@ -323,6 +394,10 @@ LXQtPanelApplication::LXQtPanelApplication(int& argc, char** argv)
 {
     Q_D(LXQtPanelApplication);
 
+    // Create the profiler first, so that its time base is the application start
+    LXQtPanelProfiler *profiler = LXQtPanelProfiler::instance();
+    const qint64 startTime = profiler->now();
+
     QCoreApplication::setApplicationName(QLatin1String("lxqt-panel"));
     const QString VERINFO = QStringLiteral(LXQT_PANEL_VERSION
                                            "\nliblxqt   " LXQT_VERSION
@@ -341,8 +416,16 @@ LXQtPanelApplication::LXQtPanelApplication(int& argc, char** argv)
             QCoreApplication::translate("main", "Configuration file"));
     parser.addOption(configFileOption);
 
+    QCommandLineOption profileOption(QLatin1String("profile"),
+            QCoreApplication::translate("main", "Write a startup profile in Chrome trace format to the file."),
+            QCoreApplication::translate("main", "Profile file"));
+    parser.addOption(profileOption);
+
     parser.process(*this);
 
+    if (parser.isSet(profileOption))
+        profiler->setOutputFile(parser.value(profileOption));
+
     const QString configFile = parser.value(configFileOption);
 
     if (configFile.isEmpty())
@@ -418,6 +501,9 @@ LXQtPanelApplication::LXQtPanelApplication(int& argc, char** argv)
     // if no panel can be added on Wayland, forcefully add the first one
     if (mPanels.isEmpty())
         addPanel(panels.at(0));
+
+    if (LXQtPanelProfiler::isEnabled())
+        profiler->addSpan(QStringLiteral("LXQtPanelApplication"), QStringLiteral("startup"), startTime, profiler->now());
 }
 
 LXQtPanelApplication::~LXQtPanelApplication()
@@ -452,6 +538,8 @@ LXQtPanel* LXQtPanelApplication::addPanel(const QString& name)
 {
     Q_D(LXQtPanelApplication);
 
+    LXQtPanelProfileScope profile(QStringLiteral("LXQtPanel"), QStringLiteral("panel"),
+                                  {{QStringLiteral("name"), name}});
     LXQtPanel *panel = new LXQtPanel(name, d->mSettings);
     mPanels << panel;
 
@@ -58,9 +58,9 @@ public:
      * \brief Creates a new LXQtPanelApplication with the given command line
      * arguments. Performs the following steps:
      * 1. Initializes the LXQt::Application, sets application name and version.
-     * 2. Handles command line arguments. Currently, the only cmdline argument
-     * is -c = -config = -configfile which chooses a different config file
-     * for the LXQt::Settings.
+     * 2. Handles command line arguments: -c = -config = -configfile chooses
+     * a different config file for the LXQt::Settings and --profile writes a
+     * startup profile (see LXQtPanelProfiler).
      * 3. Creates the LXQt::Settings.
      * 4. Connects QCoreApplication::aboutToQuit to cleanup().
      * 5. Calls addPanel() for each panel found in the config file. If there is
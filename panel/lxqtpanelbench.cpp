@@ -0,0 +1,319 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * LXQt - a lightweight, Qt based, desktop toolset
+ * https://lxqt.org
+ *
+ * Copyright: 2024 LXQt team
+ *
+ * This program or library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+
+#include "lxqtpanelapplication.h"
+#include "lxqtpanel.h"
+#include "lxqtpanellayout.h"
+#include "lxqtpanelprofiler.h"
+#include "plugin.h"
+
+#include <QApplication>
+#include <QColor>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QtDebug>
+
+#include <algorithm>
+#include <cstdio>
+
+/*! lxqt-panel-bench runs the real panel on the offscreen platform with the
+  dummy window manager backend and a generated configuration, and prints the
+  timings as JSON. "--backend synthetic" uses the synthetic backend instead,
+  if it is built (see LXQT_PANEL_SYNTHETIC_SCENARIO).
+  Usage: lxqt-panel-bench [--panels M] [--plugins N] [--iterations K]
+                          [--types ID,...] [--backend NAME] [--output FILE]
+ */
+
+#define BENCH_DEFAULT_PANELS     2
+#define BENCH_DEFAULT_PLUGINS    10
+#define BENCH_DEFAULT_ITERATIONS 100
+#define BENCH_DEFAULT_TYPES      "mainmenu,quicklaunch,taskbar,desktopswitch,spacer,worldclock,showdesktop"
+#define BENCH_DEFAULT_BACKEND    "dummy"
+#define BENCH_DESKTOP            "lxqt-panel-bench"
+
+/************************************************
+
+ ************************************************/
+static void writeConfig(const QString &fileName, int panels, int plugins, const QStringList &types, const QString &backend)
+{
+    static const QStringList positions{QStringLiteral("Bottom"), QStringLiteral("Top"),
+                                       QStringLiteral("Left"), QStringLiteral("Right")};
+
+    QSettings settings(fileName, QSettings::IniFormat);
+    settings.setValue(QStringLiteral("preferred_backend"), QStringList{QStringLiteral(BENCH_DESKTOP ":") + backend});
+
+    QStringList panelNames;
+    for (int p = 0; p < panels; ++p)
+    {
+        const QString panelName = QStringLiteral("panel%1").arg(p + 1);
+        panelNames << panelName;
+
+        QStringList pluginNames;
+        for (int i = 0; i < plugins; ++i)
+        {
+            const QString type = types.at(i % types.size());
+            const QString pluginName = QStringLiteral("%1_%2_%3").arg(type).arg(p + 1).arg(i + 1);
+            pluginNames << pluginName;
+
+            settings.beginGroup(pluginName);
+            settings.setValue(QStringLiteral("type"), type);
+            settings.endGroup();
+        }
+
+        settings.beginGroup(panelName);
+        settings.setValue(QStringLiteral("plugins"), pluginNames);
+        settings.setValue(QStringLiteral("position"), positions.at(p % positions.size()));
+        settings.setValue(QStringLiteral("desktop"), 0);
+        settings.setValue(QStringLiteral("staged-plugin-loading"), false);
+        settings.endGroup();
+    }
+    settings.setValue(QStringLiteral("panels"), panelNames);
+    settings.sync();
+}
+
+
+/************************************************
+  Sums the durations of the given span in the startup profile.
+ ************************************************/
+static qint64 spanTotal(const QString &traceFile, const QString &name)
+{
+    QFile file(traceFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    qint64 total = 0;
+    const QJsonArray events = QJsonDocument::fromJson(file.readAll()).object().value(QLatin1String("traceEvents")).toArray();
+    for (const QJsonValue &event : events)
+    {
+        const QJsonObject obj = event.toObject();
+        if (obj.value(QLatin1String("name")).toString() == name)
+            total += obj.value(QLatin1String("dur")).toInteger();
+    }
+    return total;
+}
+
+
+/************************************************
+
+ ************************************************/
+static QJsonObject statistics(QList<qint64> samples)
+{
+    QJsonObject obj;
+    if (samples.isEmpty())
+        return obj;
+
+    std::sort(samples.begin(), samples.end());
+    qint64 sum = 0;
+    for (qint64 sample : std::as_const(samples))
+        sum += sample;
+
+    obj[QLatin1String("mean")] = static_cast<double>(sum) / samples.size();
+    obj[QLatin1String("median")] = samples.at(samples.size() / 2);
+    obj[QLatin1String("min")] = samples.first();
+    obj[QLatin1String("max")] = samples.last();
+    return obj;
+}
+
+
+/************************************************
+
+ ************************************************/
+static QList<LXQtPanel*> panels()
+{
+    QList<LXQtPanel*> list;
+    const auto widgets = QApplication::topLevelWidgets();
+    for (QWidget *widget : widgets)
+    {
+        if (LXQtPanel *panel = qobject_cast<LXQtPanel*>(widget))
+            list << panel;
+    }
+    return list;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i)
+        arguments << QString::fromLocal8Bit(argv[i]);
+
+    // The application is not created yet, so the arguments are parsed by hand.
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QLatin1String("LXQt Panel benchmark"));
+    const QCommandLineOption helpOption(QStringList() << QLatin1String("h") << QLatin1String("help"));
+    const QCommandLineOption panelsOption(QLatin1String("panels"),
+            QLatin1String("Number of panels (default: " QT_STRINGIFY(BENCH_DEFAULT_PANELS) ")."), QLatin1String("M"));
+    const QCommandLineOption pluginsOption(QLatin1String("plugins"),
+            QLatin1String("Number of plugins per panel (default: " QT_STRINGIFY(BENCH_DEFAULT_PLUGINS) ")."), QLatin1String("N"));
+    const QCommandLineOption iterationsOption(QLatin1String("iterations"),
+            QLatin1String("Number of relayout and style sheet runs (default: " QT_STRINGIFY(BENCH_DEFAULT_ITERATIONS) ")."), QLatin1String("K"));
+    const QCommandLineOption typesOption(QLatin1String("types"),
+            QLatin1String("Comma separated plugin ids, used in turn (default: " BENCH_DEFAULT_TYPES ")."), QLatin1String("ids"));
+    const QCommandLineOption backendOption(QLatin1String("backend"),
+            QLatin1String("Window manager backend (default: " BENCH_DEFAULT_BACKEND ")."), QLatin1String("name"));
+    const QCommandLineOption outputOption(QLatin1String("output"),
+            QLatin1String("Write the results to the file instead of the standard output."), QLatin1String("file"));
+    parser.addOptions({helpOption, panelsOption, pluginsOption, iterationsOption, typesOption, backendOption, outputOption});
+
+    if (!parser.parse(arguments))
+    {
+        fprintf(stderr, "%s\n", qPrintable(parser.errorText()));
+        return 1;
+    }
+    if (parser.isSet(helpOption))
+    {
+        printf("%s", qPrintable(parser.helpText()));
+        return 0;
+    }
+
+    const int panelCount = std::max(1, parser.isSet(panelsOption) ? parser.value(panelsOption).toInt() : BENCH_DEFAULT_PANELS);
+    const int pluginCount = std::max(0, parser.isSet(pluginsOption) ? parser.value(pluginsOption).toInt() : BENCH_DEFAULT_PLUGINS);
+    const int iterations = std::max(1, parser.isSet(iterationsOption) ? parser.value(iterationsOption).toInt() : BENCH_DEFAULT_ITERATIONS);
+    QStringList types = parser.value(typesOption).split(QLatin1Char(','), Qt::SkipEmptyParts);
+    if (types.isEmpty())
+        types = QString::fromLatin1(BENCH_DEFAULT_TYPES).split(QLatin1Char(','));
+    const QString backend = parser.isSet(backendOption) ? parser.value(backendOption) : QStringLiteral(BENCH_DEFAULT_BACKEND);
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid())
+    {
+        fprintf(stderr, "Can't create a temporary directory: %s\n", qPrintable(tempDir.errorString()));
+        return 1;
+    }
+
+    const QString configFile = tempDir.filePath(QStringLiteral("panel.conf"));
+    const QString traceFile = tempDir.filePath(QStringLiteral("trace.json"));
+    writeConfig(configFile, panelCount, pluginCount, types, backend);
+
+    // Keep the run independent of the user's session and configuration
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("XDG_CURRENT_DESKTOP", BENCH_DESKTOP);
+    qunsetenv("XDG_SESSION_TYPE");
+    qunsetenv("LXQT_PANEL_PROFILE");
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(tempDir.filePath(QStringLiteral("config"))));
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(tempDir.filePath(QStringLiteral("cache"))));
+
+    QByteArray arg0 = argc > 0 ? QByteArray(argv[0]) : QByteArrayLiteral("lxqt-panel-bench");
+    QByteArray configArg = QFile::encodeName(configFile);
+    QByteArray profileArg = QFile::encodeName(traceFile);
+    char configOpt[] = "--config";
+    char profileOpt[] = "--profile";
+    char *appArgv[] = {arg0.data(), configOpt, configArg.data(), profileOpt, profileArg.data(), nullptr};
+    int appArgc = 5;
+
+    QJsonObject results;
+
+    QElapsedTimer timer;
+    timer.start();
+    LXQtPanelApplication app(appArgc, appArgv);
+    results[QLatin1String("coldStart")] = timer.nsecsElapsed() / 1000;
+
+    // Have the profiler write the spans recorded so far
+    if (LXQtPanelProfiler::isEnabled())
+        LXQtPanelProfiler::instance()->write();
+    results[QLatin1String("pluginLoad")] = spanTotal(traceFile, QStringLiteral("loadPlugins"));
+
+    int loadedPlugins = 0;
+    QList<qint64> relayout;
+    QList<qint64> styleSheet;
+
+    QTimer::singleShot(0, &app, [&] {
+        const QList<LXQtPanel*> allPanels = panels();
+        QList<LXQtPanelLayout*> layouts;
+        for (LXQtPanel *panel : allPanels)
+        {
+            loadedPlugins += panel->findChildren<Plugin*>().size();
+            if (LXQtPanelLayout *layout = panel->findChild<LXQtPanelLayout*>())
+                layouts << layout;
+        }
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            timer.restart();
+            for (LXQtPanelLayout *layout : std::as_const(layouts))
+            {
+                layout->invalidate();
+                layout->activate();
+            }
+            relayout << timer.nsecsElapsed() / 1000;
+        }
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const QColor color = (i % 2) ? QColor(Qt::black) : QColor(Qt::white);
+            timer.restart();
+            for (LXQtPanel *panel : allPanels)
+                panel->setFontColor(color, false);
+            styleSheet << timer.nsecsElapsed() / 1000;
+        }
+
+        // Teardown is measured until exec() returns, the panels are deleted on aboutToQuit
+        timer.restart();
+        app.quit();
+    });
+
+    app.exec();
+    results[QLatin1String("teardown")] = timer.nsecsElapsed() / 1000;
+    results[QLatin1String("relayout")] = statistics(relayout);
+    results[QLatin1String("styleSheet")] = statistics(styleSheet);
+
+    QJsonObject config;
+    config[QLatin1String("panels")] = panelCount;
+    config[QLatin1String("pluginsPerPanel")] = pluginCount;
+    config[QLatin1String("iterations")] = iterations;
+    config[QLatin1String("types")] = QJsonArray::fromStringList(types);
+    config[QLatin1String("backend")] = backend;
+
+    QJsonObject report;
+    report[QLatin1String("config")] = config;
+    report[QLatin1String("loadedPlugins")] = loadedPlugins;
+    report[QLatin1String("unit")] = QStringLiteral("us");
+    report[QLatin1String("results")] = results;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption))
+    {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate) || output.write(json) < 0)
+        {
+            fprintf(stderr, "Can't write %s: %s\n", qPrintable(output.fileName()), qPrintable(output.errorString()));
+            return 1;
+        }
+    }
+    else
+    {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    return 0;
+}
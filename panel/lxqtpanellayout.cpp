@@ -76,7 +76,8 @@ struct LayoutItemInfo
 {
     LayoutItemInfo(QLayoutItem *layoutItem=nullptr);
     QLayoutItem *item;
-    QRect geometry;
+    QRect geometry; //!< position in the grid and the cached size hint
+    QRect placed; //!< the geometry last given to the item, invalid if none
     bool separate{false};
     bool expandable{false};
 };
@@ -144,6 +145,13 @@ public:
     void invalidate() { mValid = false; }
     bool isValid() const { return mValid; }
 
+    /*! \brief Returns true if the grid was changed or the size hint of an
+     * item differs since the last call of setClean(). A layout pass with
+     * the same geometry has nothing to do for a clean grid.
+     */
+    bool isDirty() const { return mDirty; }
+    void setClean() { mDirty = false; }
+
     QSize sizeHint() const { return mSizeHint; }
 
     bool horiz() const { return mHoriz; }
@@ -163,6 +171,7 @@ private:
     int mUsedColCount;
     int mRowCount;
     bool mValid;
+    bool mDirty;
     int mExpandableSize;
     int mLineSize;
 
@@ -206,6 +215,7 @@ void LayoutItemGrid::clear()
     mNextCol = 0;
     mInfoItems.resize(0);
     mValid = false;
+    mDirty = true;
     mExpandable = false;
     mExpandableSize = 0;
     mUsedColCount = 0;
@@ -336,8 +346,13 @@ void LayoutItemGrid::update()
                 if (!info.item)
                     continue;
 
-                QSize sz = info.item->sizeHint();
-                info.geometry = QRect(QPoint(x, y), sz);
+                const QSize sz = info.item->sizeHint();
+                const QRect geometry(QPoint(x, y), sz);
+                if (info.geometry != geometry)
+                {
+                    info.geometry = geometry;
+                    mDirty = true;
+                }
                 y += sz.height();
                 rw = std::max(rw, sz.width());
             }
@@ -364,8 +379,13 @@ void LayoutItemGrid::update()
                 if (!info.item)
                     continue;
 
-                QSize sz = info.item->sizeHint();
-                info.geometry = QRect(QPoint(x, y), sz);
+                const QSize sz = info.item->sizeHint();
+                const QRect geometry(QPoint(x, y), sz);
+                if (info.geometry != geometry)
+                {
+                    info.geometry = geometry;
+                    mDirty = true;
+                }
                 x += sz.width();
                 rh = std::max(rh, sz.height());
             }
@@ -389,6 +409,7 @@ void LayoutItemGrid::update()
 void LayoutItemGrid::setLineSize(int value)
 {
     mLineSize = std::max(1, value);
+    mDirty = true;
     invalidate();
 }
 
@@ -408,6 +429,7 @@ void LayoutItemGrid::setColCount(int value)
 void LayoutItemGrid::setHoriz(bool value)
 {
     mHoriz = value;
+    mDirty = true;
     invalidate();
 }
 
@@ -421,7 +443,8 @@ LXQtPanelLayout::LXQtPanelLayout(QWidget *parent) :
     mLeftGrid(new LayoutItemGrid()),
     mRightGrid(new LayoutItemGrid()),
     mPosition(ILXQtPanel::PositionBottom),
-    mAnimate(false)
+    mAnimate(false),
+    mLastRightToLeft(false)
 {
     setContentsMargins(0, 0, 0, 0);
 }
@@ -448,6 +471,10 @@ void LXQtPanelLayout::addItem(QLayoutItem *item)
     if (p && p->alignment() == Plugin::AlignLeft)
         grid = mLeftGrid;
 
+    PluginPlaceholder *placeholder = qobject_cast<PluginPlaceholder*>(item->widget());
+    if (placeholder && placeholder->alignment() == Plugin::AlignLeft)
+        grid = mLeftGrid;
+
     grid->addItem(item);
 }
 
@@ -602,7 +629,16 @@ void LXQtPanelLayout::setGeometry(const QRect &geometry)
 
     QRect my_geometry{geometry};
     my_geometry -= contentsMargins();
-    if (count())
+
+    // An invalidation often comes from an item whose size hint did not change
+    // (e.g. a clock redrawing the same width), then there is nothing to place.
+    const bool rightToLeft = parentWidget() && parentWidget()->isRightToLeft();
+    const bool changed = mAnimate
+            || mLeftGrid->isDirty() || mRightGrid->isDirty()
+            || my_geometry != mLastGeometry
+            || rightToLeft != mLastRightToLeft;
+
+    if (count() && changed)
     {
         if (isHorizontal())
             setGeometryHoriz(my_geometry);
@@ -610,6 +646,11 @@ void LXQtPanelLayout::setGeometry(const QRect &geometry)
             setGeometryVert(my_geometry);
     }
 
+    mLeftGrid->setClean();
+    mRightGrid->setClean();
+    mLastGeometry = my_geometry;
+    mLastRightToLeft = rightToLeft;
+
     mAnimate = false;
     QLayout::setGeometry(my_geometry);
 }
@@ -618,8 +659,14 @@ void LXQtPanelLayout::setGeometry(const QRect &geometry)
 /************************************************
 
  ************************************************/
-void LXQtPanelLayout::setItemGeometry(QLayoutItem *item, const QRect &geometry, bool withAnimation)
+void LXQtPanelLayout::setItemGeometry(LayoutItemInfo &info, const QRect &geometry, bool withAnimation)
 {
+    QLayoutItem *item = info.item;
+
+    // Items in front of a changed one keep their place, skip them
+    if (!withAnimation && info.placed == geometry)
+        return;
+
     Plugin *plugin = qobject_cast<Plugin*>(item->widget());
     if (withAnimation && plugin)
     {
@@ -632,6 +679,9 @@ void LXQtPanelLayout::setItemGeometry(QLayoutItem *item, const QRect &geometry,
     {
         item->setGeometry(geometry);
     }
+
+    // A hidden item ignores the geometry, it has to be set once it is shown
+    info.placed = item->isEmpty() ? QRect() : geometry;
 }
 
 
@@ -685,7 +735,7 @@ void LXQtPanelLayout::setGeometryHoriz(const QRect &geometry)
         int remain = height_remain;
         for (int c=0; c<mLeftGrid->usedColCount(); ++c)
         {
-            const LayoutItemInfo &info = mLeftGrid->itemInfo(r, c);
+            LayoutItemInfo &info = mLeftGrid->itemInfo(r, c);
             if (info.item)
             {
                 QRect rect;
@@ -718,7 +768,7 @@ void LXQtPanelLayout::setGeometryHoriz(const QRect &geometry)
                 rw = std::max(rw, rect.width());
                 if (visual_h_reversed)
                     rect.moveLeft(geometry.left() + geometry.right() - rect.x() - rect.width() + 1);
-                setItemGeometry(info.item, rect, mAnimate);
+                setItemGeometry(info, rect, mAnimate);
             }
         }
         left += rw;
@@ -732,7 +782,7 @@ void LXQtPanelLayout::setGeometryHoriz(const QRect &geometry)
         int remain = height_remain;
         for (int c=0; c<mRightGrid->usedColCount(); ++c)
         {
-            const LayoutItemInfo &info = mRightGrid->itemInfo(r, c);
+            LayoutItemInfo &info = mRightGrid->itemInfo(r, c);
             if (info.item)
             {
                 QRect rect;
@@ -766,7 +816,7 @@ void LXQtPanelLayout::setGeometryHoriz(const QRect &geometry)
                 rw = std::max(rw, rect.width());
                 if (visual_h_reversed)
                     rect.moveLeft(geometry.left() + geometry.right() - rect.x() - rect.width() + 1);
-                setItemGeometry(info.item, rect, mAnimate);
+                setItemGeometry(info, rect, mAnimate);
             }
         }
         right -= rw;
@@ -823,7 +873,7 @@ void LXQtPanelLayout::setGeometryVert(const QRect &geometry)
         int remain = width_remain;
         for (int c=0; c<mLeftGrid->usedColCount(); ++c)
         {
-            const LayoutItemInfo &info = mLeftGrid->itemInfo(r, c);
+            LayoutItemInfo &info = mLeftGrid->itemInfo(r, c);
             if (info.item)
             {
                 QRect rect;
@@ -856,7 +906,7 @@ void LXQtPanelLayout::setGeometryVert(const QRect &geometry)
                 rh = std::max(rh, rect.height());
                 if (visual_h_reversed)
                     rect.moveLeft(geometry.left() + geometry.right() - rect.x() - rect.width() + 1);
-                setItemGeometry(info.item, rect, mAnimate);
+                setItemGeometry(info, rect, mAnimate);
             }
         }
         top += rh;
@@ -871,7 +921,7 @@ void LXQtPanelLayout::setGeometryVert(const QRect &geometry)
         int remain = width_remain;
         for (int c=0; c<mRightGrid->usedColCount(); ++c)
         {
-            const LayoutItemInfo &info = mRightGrid->itemInfo(r, c);
+            LayoutItemInfo &info = mRightGrid->itemInfo(r, c);
             if (info.item)
             {
                 QRect rect;
@@ -904,7 +954,7 @@ void LXQtPanelLayout::setGeometryVert(const QRect &geometry)
                 rh = std::max(rh, rect.height());
                 if (visual_h_reversed)
                     rect.moveLeft(geometry.left() + geometry.right() - rect.x() - rect.width() + 1);
-                setItemGeometry(info.item, rect, mAnimate);
+                setItemGeometry(info, rect, mAnimate);
             }
         }
         bottom -= rh;
@@ -1068,3 +1118,23 @@ void LXQtPanelLayout::addPlugin(Plugin * plugin)
     if (prev_count > pos)
         moveItem(pos, prev_count, false);
 }
+
+/************************************************
+
+ ************************************************/
+void LXQtPanelLayout::replacePlaceholder(PluginPlaceholder * placeholder, Plugin * plugin)
+{
+    const int to = placeholder ? indexOf(placeholder) : -1;
+    if (plugin)
+    {
+        connect(plugin, &Plugin::startMove, this, &LXQtPanelLayout::startMovePlugin);
+        addWidget(plugin);
+
+        // the plugin and its placeholder have the same alignment, so they are in the same grid
+        if (to >= 0)
+            moveItem(indexOf(plugin), to, false);
+    }
+
+    if (to >= 0)
+        removeWidget(placeholder);
+}
@@ -41,7 +41,9 @@ class QMouseEvent;
 class QEvent;
 
 class Plugin;
+class PluginPlaceholder;
 class LayoutItemGrid;
+struct LayoutItemInfo;
 
 class LXQT_PANEL_API LXQtPanelLayout : public QLayout
 {
@@ -86,6 +88,11 @@ public slots:
     void finishMovePlugin();
     void moveUpPlugin(Plugin * plugin);
     void addPlugin(Plugin * plugin);
+    /*! \brief Puts the deferred plugin at the place of its placeholder and
+     * removes the placeholder. If the plugin could not be loaded (nullptr),
+     * just the placeholder is removed.
+     */
+    void replacePlaceholder(PluginPlaceholder * placeholder, Plugin * plugin);
 
 private:
     mutable QSize mMinPluginSize;
@@ -93,6 +100,8 @@ private:
     LayoutItemGrid *mRightGrid;
     ILXQtPanel::Position mPosition;
     bool mAnimate;
+    QRect mLastGeometry;
+    bool mLastRightToLeft;
 
 
     void setGeometryHoriz(const QRect &geometry);
@@ -100,7 +109,7 @@ private:
     void globalIndexToLocal(int index, LayoutItemGrid **grid, int *gridIndex);
     void globalIndexToLocal(int index, LayoutItemGrid **grid, int *gridIndex) const;
 
-    void setItemGeometry(QLayoutItem *item, const QRect &geometry, bool withAnimation);
+    void setItemGeometry(LayoutItemInfo &info, const QRect &geometry, bool withAnimation);
 };
 
 #endif // LXQTPANELLAYOUT_H
@@ -44,4 +44,6 @@
 #define PANEL_SHOW_DELAY 0
 
 #define SETTINGS_SAVE_DELAY 3000
+
+#define PROFILER_FLUSH_DELAY 2000
 #endif // LXQTPANELLIMITS_H
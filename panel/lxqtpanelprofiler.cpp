@@ -0,0 +1,180 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * LXQt - a lightweight, Qt based, desktop toolset
+ * https://lxqt.org
+ *
+ * Copyright: 2024 LXQt team
+ *
+ * This program or library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "lxqtpanelprofiler.h"
+#include "lxqtpanellimits.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+#include <QDebug>
+
+LXQtPanelProfiler *LXQtPanelProfiler::mInstance = nullptr;
+
+/************************************************
+
+ ************************************************/
+LXQtPanelProfiler::LXQtPanelProfiler(QObject *parent) :
+    QObject(parent)
+{
+    mTimer.start();
+
+    mFlushTimer.setSingleShot(true);
+    mFlushTimer.setInterval(PROFILER_FLUSH_DELAY);
+    connect(&mFlushTimer, &QTimer::timeout, this, &LXQtPanelProfiler::write);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &LXQtPanelProfiler::write);
+}
+
+
+/************************************************
+
+ ************************************************/
+LXQtPanelProfiler::~LXQtPanelProfiler()
+{
+    if (mFlushTimer.isActive())
+        write();
+    mInstance = nullptr;
+}
+
+
+/************************************************
+
+ ************************************************/
+LXQtPanelProfiler *LXQtPanelProfiler::instance()
+{
+    if (!mInstance)
+    {
+        mInstance = new LXQtPanelProfiler(qApp);
+        mInstance->setOutputFile(qEnvironmentVariable("LXQT_PANEL_PROFILE"));
+    }
+    return mInstance;
+}
+
+
+/************************************************
+
+ ************************************************/
+void LXQtPanelProfiler::setOutputFile(const QString &fileName)
+{
+    QMutexLocker locker(&mMutex);
+    mFileName = fileName;
+    if (!mFileName.isEmpty())
+        qDebug() << "Writing startup profile to" << mFileName;
+}
+
+
+/************************************************
+
+ ************************************************/
+void LXQtPanelProfiler::addSpan(const QString &name, const QString &category, qint64 start, qint64 end, const QVariantMap &args)
+{
+    QJsonObject event;
+    event[QLatin1String("name")] = name;
+    event[QLatin1String("cat")] = category;
+    event[QLatin1String("ph")] = QStringLiteral("X");
+    event[QLatin1String("ts")] = start;
+    event[QLatin1String("dur")] = end - start;
+    event[QLatin1String("pid")] = QCoreApplication::applicationPid();
+    event[QLatin1String("tid")] = static_cast<qint64>(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    if (!args.isEmpty())
+        event[QLatin1String("args")] = QJsonObject::fromVariantMap(args);
+
+    {
+        QMutexLocker locker(&mMutex);
+        if (mFileName.isEmpty())
+            return;
+        mEvents.append(event);
+    }
+
+    // (re)start the flush timer in our own thread
+    QMetaObject::invokeMethod(this, [this] { mFlushTimer.start(); });
+}
+
+
+/************************************************
+
+ ************************************************/
+void LXQtPanelProfiler::write()
+{
+    mFlushTimer.stop();
+
+    QMutexLocker locker(&mMutex);
+    if (mFileName.isEmpty())
+        return;
+
+    QJsonObject trace;
+    trace[QLatin1String("traceEvents")] = mEvents;
+    trace[QLatin1String("displayTimeUnit")] = QStringLiteral("ms");
+
+    QSaveFile file(mFileName);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0
+            || !file.commit())
+    {
+        qWarning() << "Can't write the startup profile to" << mFileName << file.errorString();
+    }
+}
+
+
+/************************************************
+
+ ************************************************/
+LXQtPanelProfileScope::LXQtPanelProfileScope(const QString &name, const QString &category, const QVariantMap &args) :
+    mStart(-1)
+{
+    if (!LXQtPanelProfiler::isEnabled())
+        return;
+
+    mName = name;
+    mCategory = category;
+    mArgs = args;
+    mStart = LXQtPanelProfiler::instance()->now();
+}
+
+
+/************************************************
+
+ ************************************************/
+void LXQtPanelProfileScope::setArgument(const QString &key, const QVariant &value)
+{
+    if (mStart >= 0)
+        mArgs[key] = value;
+}
+
+
+/************************************************
+
+ ************************************************/
+void LXQtPanelProfileScope::finish()
+{
+    if (mStart < 0 || !LXQtPanelProfiler::isEnabled())
+        return;
+
+    LXQtPanelProfiler *profiler = LXQtPanelProfiler::instance();
+    profiler->addSpan(mName, mCategory, mStart, profiler->now(), mArgs);
+    mStart = -1;
+}
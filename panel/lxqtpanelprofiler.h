@@ -0,0 +1,128 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * LXQt - a lightweight, Qt based, desktop toolset
+ * https://lxqt.org
+ *
+ * Copyright: 2024 LXQt team
+ *
+ * This program or library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef LXQTPANELPROFILER_H
+#define LXQTPANELPROFILER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QMutex>
+#include <QTimer>
+#include <QVariantMap>
+
+/*!
+ * \brief The LXQtPanelProfiler class records timing spans of the panel
+ * startup and writes them as Chrome trace-event JSON, which can be opened
+ * with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * The profiler is off by default. It is switched on by setting the
+ * LXQT_PANEL_PROFILE environment variable or passing --profile to
+ * lxqt-panel, both taking the name of the output file. While it is off,
+ * recording a span costs a single pointer check.
+ *
+ * The trace is rewritten as a whole after the last span has been recorded
+ * (see PROFILER_FLUSH_DELAY) and on exit, so the file is always valid JSON
+ * even though the panel normally never quits.
+ */
+class LXQtPanelProfiler : public QObject
+{
+    Q_OBJECT
+public:
+    ~LXQtPanelProfiler();
+
+    /*!
+     * \brief Creates the profiler if it does not exist yet. It is a child of
+     * the application, so this must be called after QApplication is created.
+     * The LXQT_PANEL_PROFILE environment variable is checked here.
+     */
+    static LXQtPanelProfiler *instance();
+
+    /*!
+     * \brief Returns true if spans are being recorded.
+     */
+    static bool isEnabled() { return mInstance && !mInstance->mFileName.isEmpty(); }
+
+    /*!
+     * \brief Starts recording and sets the file the trace is written to.
+     * An empty file name disables the profiler.
+     */
+    void setOutputFile(const QString &fileName);
+    QString outputFile() const { return mFileName; }
+
+    /*!
+     * \brief Microseconds elapsed since the profiler was created. This is
+     * the time base of all recorded spans.
+     */
+    qint64 now() const { return mTimer.nsecsElapsed() / 1000; }
+
+    /*!
+     * \brief Records a complete span. May be called from any thread.
+     * \param start and end are values returned by now().
+     */
+    void addSpan(const QString &name, const QString &category, qint64 start, qint64 end, const QVariantMap &args = QVariantMap());
+
+public slots:
+    /*!
+     * \brief Writes all spans recorded so far to the output file.
+     */
+    void write();
+
+private:
+    explicit LXQtPanelProfiler(QObject *parent);
+
+    static LXQtPanelProfiler *mInstance;
+
+    QString mFileName;
+    QElapsedTimer mTimer;
+    QTimer mFlushTimer;
+    mutable QMutex mMutex;
+    QJsonArray mEvents;
+};
+
+/*!
+ * \brief The LXQtPanelProfileScope class records a span that lasts from
+ * its construction until its destruction, or until finish() is called.
+ * It does nothing if the profiler is disabled.
+ */
+class LXQtPanelProfileScope
+{
+public:
+    LXQtPanelProfileScope(const QString &name, const QString &category, const QVariantMap &args = QVariantMap());
+    ~LXQtPanelProfileScope() { finish(); }
+
+    void setArgument(const QString &key, const QVariant &value);
+    void finish();
+
+private:
+    QString mName;
+    QString mCategory;
+    QVariantMap mArgs;
+    qint64 mStart;
+
+    Q_DISABLE_COPY(LXQtPanelProfileScope)
+};
+
+#endif // LXQTPANELPROFILER_H
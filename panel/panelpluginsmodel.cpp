@@ -28,26 +28,56 @@
 #include "ilxqtpanelplugin.h"
 #include "lxqtpanel.h"
 #include "lxqtpanelapplication.h"
+#include "lxqtpanelprofiler.h"
+#include "plugininfoindex.h"
+#include "lxqtpanellimits.h"
 #include <QPointer>
 #include <XdgIcon>
 #include <LXQt/Settings>
 
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+// Plugins that make the panel usable, their loading is never deferred
+static const QStringList PRIORITY_PLUGINS = {
+    QStringLiteral("fancymenu"),
+    QStringLiteral("mainmenu"),
+    QStringLiteral("taskbar"),
+    QStringLiteral("worldclock")
+};
+
+static QString placeholderCacheFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+        + QStringLiteral("/lxqt-panel/placeholders.conf");
+}
 
 PanelPluginsModel::PanelPluginsModel(LXQtPanel * panel,
                                      QString const & namesKey,
                                      QStringList const & desktopDirs,
+                                     bool stagedLoading/* = false*/,
                                      QObject * parent/* = nullptr*/)
     : QAbstractListModel{parent},
     mNamesKey(namesKey),
-    mPanel(panel)
+    mPanel(panel),
+    mDesktopDirs(desktopDirs)
 {
-    loadPlugins(desktopDirs);
+    mDeferredTimer.setSingleShot(true);
+    mDeferredTimer.setInterval(0);
+    connect(&mDeferredTimer, &QTimer::timeout, this, &PanelPluginsModel::loadNextDeferredPlugin);
+
+    loadPlugins(desktopDirs, stagedLoading);
 }
 
 PanelPluginsModel::~PanelPluginsModel()
 {
     qDeleteAll(plugins());
+    for (auto const & placeholder : std::as_const(mPlaceholders))
+        delete placeholder.data();
 }
 
 int PanelPluginsModel::rowCount(const QModelIndex & parent/* = QModelIndex()*/) const
@@ -116,6 +146,11 @@ Plugin* PanelPluginsModel::pluginByName(QString name) const
     return nullptr;
 }
 
+PluginPlaceholder * PanelPluginsModel::placeholder(QString const & name) const
+{
+    return mPlaceholders.value(name).data();
+}
+
 Plugin const * PanelPluginsModel::pluginByID(QString id) const
 {
     for (auto const & p : mPlugins)
@@ -149,6 +184,13 @@ void PanelPluginsModel::removePlugin(pluginslist_t::iterator plugin)
 {
     if (mPlugins.end() != plugin)
     {
+        // a deferred plugin may be removed before being loaded
+        const QString & name = plugin->first;
+        mDeferredPlugins.erase(std::remove_if(mDeferredPlugins.begin(), mDeferredPlugins.end(),
+                               [&name] (std::pair<QString, QString> const & p) { return p.first == name; }),
+                               mDeferredPlugins.end());
+        delete mPlaceholders.take(name).data();
+
         mPanel->settings()->remove(plugin->first);
         Plugin * p = plugin->second.data();
         const int row = plugin - mPlugins.begin();
@@ -215,15 +257,15 @@ void PanelPluginsModel::movePlugin(Plugin * plugin, QString const & nameAfter)
     }
 }
 
-void PanelPluginsModel::loadPlugins(QStringList const & desktopDirs)
+void PanelPluginsModel::loadPlugins(QStringList const & desktopDirs, bool stagedLoading)
 {
     QStringList plugin_names = mPanel->settings()->value(mNamesKey).toStringList();
 
-#ifdef DEBUG_PLUGIN_LOADTIME
-    QElapsedTimer timer;
-    timer.start();
-    qint64 lastTime = 0;
-#endif
+    QSettings placeholderSizes(placeholderCacheFile(), QSettings::IniFormat);
+    placeholderSizes.beginGroup(mPanel->name());
+    QStringList deferredTypes;
+    QList<std::pair<int/*row*/, QString/*type*/> > immediatePlugins;
+
     for (auto const & name : std::as_const(plugin_names))
     {
         pluginslist_t::iterator i = mPlugins.insert(mPlugins.end(), {name, nullptr});
@@ -253,19 +295,110 @@ void PanelPluginsModel::loadPlugins(QStringList const & desktopDirs)
         }
 #endif
 
-        LXQt::PluginInfoList list = LXQt::PluginInfo::search(desktopDirs, QStringLiteral("LXQtPanel/Plugin"), QStringLiteral("%1.desktop").arg(type));
-        if( !list.count())
+        // The alignment of a plugin which has not been saved yet is only known after loading it
+        const QString alignment = mPanel->settings()->value(name + QStringLiteral("/alignment")).toString();
+        if (stagedLoading && !PRIORITY_PLUGINS.contains(type) && !alignment.isEmpty())
+        {
+            mDeferredPlugins.append({name, type});
+            mPlaceholders.insert(name, new PluginPlaceholder(
+                        alignment.toUpper() == QLatin1String("RIGHT") ? Plugin::AlignRight : Plugin::AlignLeft,
+                        placeholderSizes.value(name, QSize(0, 0)).toSize()));
+            if (!deferredTypes.contains(type))
+                deferredTypes << type;
+            continue;
+        }
+
+        immediatePlugins.append({static_cast<int>(i - mPlugins.begin()), type});
+    }
+
+    if (!deferredTypes.isEmpty())
+    {
+        // parse the .desktop files of the deferred plugins while the others are loaded
+        QThreadPool::globalInstance()->start([desktopDirs, deferredTypes] {
+            for (auto const & type : deferredTypes)
+                PluginInfoIndex::instance()->find(desktopDirs, type);
+        });
+    }
+
+    for (auto const & p : std::as_const(immediatePlugins))
+    {
+        const QString & type = p.second;
+        LXQt::PluginInfo desktopFile;
+        {
+            LXQtPanelProfileScope profile(QStringLiteral("PluginInfoIndex::find"), QStringLiteral("plugin"),
+                                          {{QStringLiteral("type"), type}});
+            desktopFile = PluginInfoIndex::instance()->find(desktopDirs, type);
+        }
+        if (!desktopFile.isValid())
         {
             qWarning() << QStringLiteral("Plugin \"%1\" not found.").arg(type);
             continue;
         }
 
-        i->second = loadPlugin(list.first(), name);
-#ifdef DEBUG_PLUGIN_LOADTIME
-        qDebug() << "load plugin" << type << "takes" << (timer.elapsed() - lastTime) << "ms";
-        lastTime = timer.elapsed();
-#endif
+        mPlugins[p.first].second = loadPlugin(desktopFile, mPlugins.at(p.first).first);
+    }
+
+    if (!deferredTypes.isEmpty())
+    {
+        mDeferredTimer.start();
+    }
+    else if (stagedLoading)
+    {
+        QTimer::singleShot(SETTINGS_SAVE_DELAY, this, &PanelPluginsModel::savePlaceholderSizes);
+    }
+}
+
+void PanelPluginsModel::loadNextDeferredPlugin()
+{
+    if (mDeferredPlugins.isEmpty())
+        return;
+
+    const auto deferred = mDeferredPlugins.takeFirst();
+    const QString & name = deferred.first;
+    const QString & type = deferred.second;
+    LXQtPanelProfileScope profile(QStringLiteral("loadDeferredPlugin"), QStringLiteral("plugin"),
+                                  {{QStringLiteral("type"), type}});
+
+    QPointer<Plugin> plugin;
+    LXQt::PluginInfo desktopFile = PluginInfoIndex::instance()->find(mDesktopDirs, type);
+    if (desktopFile.isValid())
+        plugin = loadPlugin(desktopFile, name);
+    else
+        qWarning() << QStringLiteral("Plugin \"%1\" not found.").arg(type);
+
+    auto i = std::find_if(mPlugins.begin(), mPlugins.end(),
+                          [&name] (pluginslist_t::const_reference obj) { return name == obj.first; });
+    if (mPlugins.end() != i)
+    {
+        i->second = plugin;
+        const int row = i - mPlugins.begin();
+        emit dataChanged(index(row), index(row));
+    }
+
+    PluginPlaceholder * placeholder = mPlaceholders.take(name).data();
+    emit deferredPluginLoaded(plugin.data(), placeholder);
+    delete placeholder;
+
+    if (!mDeferredPlugins.isEmpty())
+        mDeferredTimer.start();
+    else
+        QTimer::singleShot(SETTINGS_SAVE_DELAY, this, &PanelPluginsModel::savePlaceholderSizes);
+}
+
+void PanelPluginsModel::savePlaceholderSizes()
+{
+    const QString fileName = placeholderCacheFile();
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    QSettings placeholderSizes(fileName, QSettings::IniFormat);
+    placeholderSizes.beginGroup(mPanel->name());
+    placeholderSizes.remove(QString());
+    for (auto const & p : std::as_const(mPlugins))
+    {
+        if (!p.second.isNull())
+            placeholderSizes.setValue(p.first, p.second->size());
     }
+    placeholderSizes.endGroup();
 }
 
 QPointer<Plugin> PanelPluginsModel::loadPlugin(LXQt::PluginInfo const & desktopFile, QString const & settingsGroup)
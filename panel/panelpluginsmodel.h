@@ -27,6 +27,9 @@
 #define PANELPLUGINSMODEL_H
 
 #include <QAbstractListModel>
+#include <QHash>
+#include <QPointer>
+#include <QTimer>
 #include <memory>
 
 namespace LXQt
@@ -37,6 +40,7 @@ namespace LXQt
 
 class LXQtPanel;
 class Plugin;
+class PluginPlaceholder;
 
 /*!
  * \brief The PanelPluginsModel class implements the Model part of the
@@ -44,6 +48,12 @@ class Plugin;
  * to access the Plugin data associated with this Panel. The
  * PanelPluginsModel takes care for read-access as well as changes
  * like adding, removing or moving Plugins.
+ *
+ * With staged loading, only the Plugins that make the panel usable (the
+ * task bar, the clock and the menus) are loaded on construction. The
+ * others are loaded one by one from the event loop, in the meantime a
+ * PluginPlaceholder with the size the Plugin had last time reserves their
+ * place. Their .desktop files are parsed on a worker thread beforehand.
  */
 class PanelPluginsModel : public QAbstractListModel
 {
@@ -52,6 +62,7 @@ public:
     PanelPluginsModel(LXQtPanel * panel,
                       QString const & namesKey,
                       QStringList const & desktopDirs,
+                      bool stagedLoading = false,
                       QObject * parent = nullptr);
     ~PanelPluginsModel();
 
@@ -128,6 +139,13 @@ public:
      * \return the first Plugin found with the given ID.
      */
     Plugin const *pluginByID(QString id) const;
+    /*!
+     * \brief placeholder returns the PluginPlaceholder of a Plugin whose
+     * loading is deferred, or nullptr if the Plugin is not deferred.
+     * \param name is the name of the plugin as it is used in the
+     * config files.
+     */
+    PluginPlaceholder *placeholder(QString const & name) const;
 
     /*!
      * \brief movePlugin moves a Plugin in the underlying data.
@@ -196,6 +214,14 @@ signals:
      * \sa pluginMoved
      */
     void pluginMovedUp(Plugin * plugin);
+    /*!
+     * \brief deferredPluginLoaded gets emitted when a Plugin whose loading
+     * was deferred has been loaded. The placeholder is deleted afterwards.
+     * \param plugin The Plugin that was loaded. This could be a nullptr if
+     * loading failed.
+     * \param placeholder The PluginPlaceholder that reserved its place.
+     */
+    void deferredPluginLoaded(Plugin * plugin, PluginPlaceholder * placeholder);
 
 public slots:
     /*!
@@ -256,6 +282,18 @@ public slots:
      */
     void onRemovePlugin(QModelIndex const & index);
 
+private slots:
+    /*!
+     * \brief loadNextDeferredPlugin Loads the first deferred Plugin and
+     * schedules loading of the next one.
+     */
+    void loadNextDeferredPlugin();
+    /*!
+     * \brief savePlaceholderSizes Stores the sizes of the loaded Plugins in
+     * the cache, to be used as the sizes of their placeholders next time.
+     */
+    void savePlaceholderSizes();
+
 private:
     /*!
      * \brief pluginslist_t is the data type used for mPlugins which stores
@@ -270,8 +308,10 @@ private:
      * \brief loadPlugins Loads all the Plugins.
      * \param desktopDirs These directories are scanned for corresponding
      * .desktop-files which are necessary to load the plugins.
+     * \param stagedLoading Whether loading of the Plugins which are not
+     * needed for a usable panel should be deferred.
      */
-    void loadPlugins(QStringList const & desktopDirs);
+    void loadPlugins(QStringList const & desktopDirs, bool stagedLoading);
     /*!
      * \brief loadPlugin Loads a Plugin and connects signals and slots.
      * \param desktopFile The desktop file that specifies how to load the
@@ -334,6 +374,20 @@ private:
      * \brief mPanel Stores a reference to the LXQtPanel.
      */
     LXQtPanel * mPanel;
+    /*!
+     * \brief mDesktopDirs The directories with the .desktop-files.
+     */
+    const QStringList mDesktopDirs;
+    /*!
+     * \brief mDeferredPlugins The names and types of the Plugins whose
+     * loading is deferred, in the order they will be loaded.
+     */
+    QList<std::pair<QString/*name*/, QString/*type*/> > mDeferredPlugins;
+    /*!
+     * \brief mPlaceholders The placeholders of the deferred Plugins by name.
+     */
+    QHash<QString, QPointer<PluginPlaceholder> > mPlaceholders;
+    QTimer mDeferredTimer;
 };
 
 #endif // PANELPLUGINSMODEL_H
@@ -30,6 +30,7 @@
 #include "ilxqtpanelplugin.h"
 #include "pluginsettings_p.h"
 #include "lxqtpanel.h"
+#include "lxqtpanelprofiler.h"
 
 #include <KX11Extras>
 
@@ -106,8 +107,14 @@ Plugin::Plugin(const LXQt::PluginInfo &desktopFile, LXQt::Settings *settings, co
     mPlugin(nullptr),
     mPluginWidget(nullptr),
     mAlignment(AlignLeft),
-    mPanel(panel)
+    mPanel(panel),
+    mFirstPaintStart(-1)
 {
+    LXQtPanelProfileScope profile(QStringLiteral("Plugin"), QStringLiteral("plugin"),
+                                  {{QStringLiteral("id"), desktopFile.id()}, {QStringLiteral("group"), settingsGroup}});
+    if (LXQtPanelProfiler::isEnabled())
+        mFirstPaintStart = LXQtPanelProfiler::instance()->now();
+
     mSettings = PluginSettingsFactory::create(settings, settingsGroup);
 
     setWindowTitle(desktopFile.name());
@@ -494,10 +501,20 @@ bool Plugin::isExpandable() const
 /************************************************
 
  ************************************************/
-bool Plugin::eventFilter(QObject * /*watched*/, QEvent * event)
+bool Plugin::eventFilter(QObject * watched, QEvent * event)
 {
     switch (event->type())
     {
+        case QEvent::Paint:
+            if (mFirstPaintStart >= 0 && watched == mPluginWidget && LXQtPanelProfiler::isEnabled())
+            {
+                // time from the construction of the plugin until its widget is painted first
+                LXQtPanelProfiler *profiler = LXQtPanelProfiler::instance();
+                profiler->addSpan(QStringLiteral("firstPaint"), QStringLiteral("plugin"), mFirstPaintStart, profiler->now(),
+                                  {{QStringLiteral("id"), mDesktopFile.id()}, {QStringLiteral("group"), settingsGroup()}});
+                mFirstPaintStart = -1;
+            }
+            break;
         case QEvent::DragLeave:
             emit dragLeft();
             break;
@@ -553,3 +570,16 @@ void Plugin::requestRemove()
     emit remove();
     deleteLater();
 }
+
+
+/************************************************
+
+ ************************************************/
+PluginPlaceholder::PluginPlaceholder(Plugin::Alignment alignment, const QSize &size, QWidget *parent) :
+    QWidget(parent),
+    mAlignment(alignment),
+    mSize(size)
+{
+    setObjectName(QStringLiteral("PluginPlaceholder"));
+    setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+}
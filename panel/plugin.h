@@ -124,6 +124,7 @@ private:
     static QColor mMoveMarkerColor;
     QString mName;
     QPointer<QDialog> mConfigDialog; //!< plugin's config dialog (if any)
+    qint64 mFirstPaintStart; //!< start of the first paint span for the profiler, -1 if not profiled
 
 private slots:
     void settingsChanged();
@@ -132,4 +133,25 @@ private slots:
 
 Q_DECLARE_METATYPE(Plugin const *)
 
+
+/*!
+ * \brief The PluginPlaceholder class reserves the slot of a plugin whose
+ * loading is deferred (see PanelPluginsModel), so that the other plugins
+ * do not move when it is finally loaded.
+ */
+class PluginPlaceholder : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit PluginPlaceholder(Plugin::Alignment alignment, const QSize &size, QWidget *parent = nullptr);
+
+    Plugin::Alignment alignment() const { return mAlignment; }
+
+    QSize sizeHint() const override { return mSize; }
+
+private:
+    Plugin::Alignment mAlignment;
+    QSize mSize;
+};
+
 #endif // PLUGIN_H
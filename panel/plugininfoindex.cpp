@@ -0,0 +1,149 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * LXQt - a lightweight, Qt based, desktop toolset
+ * https://lxqt.org
+ *
+ * Copyright: 2024 LXQt team
+ *
+ * This program or library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "plugininfoindex.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <XdgDirs>
+
+#define PLUGIN_SERVICE_TYPE "LXQtPanel/Plugin"
+
+/************************************************
+
+ ************************************************/
+PluginInfoIndex *PluginInfoIndex::instance()
+{
+    static PluginInfoIndex index;
+    return &index;
+}
+
+
+/************************************************
+
+ ************************************************/
+QStringList PluginInfoIndex::desktopDirs()
+{
+    QStringList dirs;
+    dirs << QString::fromLocal8Bit(qgetenv("LXQT_PANEL_PLUGINS_DIR")).split(QLatin1Char(':'), Qt::SkipEmptyParts);
+    dirs << QStringLiteral("%1/%2").arg(XdgDirs::dataHome(), QStringLiteral("/lxqt/lxqt-panel"));
+    dirs << QStringLiteral(PLUGIN_DESKTOPS_DIR);
+    return dirs;
+}
+
+
+/************************************************
+
+ ************************************************/
+void PluginInfoIndex::update(const QStringList &desktopDirs)
+{
+    QList<QDateTime> lastModified;
+    lastModified.reserve(desktopDirs.size());
+    for (const QString &dir : desktopDirs)
+        lastModified << QFileInfo(dir).lastModified();
+
+    if (desktopDirs == mDirs && lastModified == mDirsLastModified)
+        return;
+
+    // keep the already parsed files, they are checked by their own time stamps
+    QHash<QString, Entry> oldEntries;
+    oldEntries.swap(mEntries);
+    mIds.clear();
+    mDirs = desktopDirs;
+    mDirsLastModified = lastModified;
+
+    for (const QString &dirName : desktopDirs)
+    {
+        const QFileInfoList files = QDir(dirName).entryInfoList(QStringList(QStringLiteral("*.desktop")), QDir::Files | QDir::Readable);
+        for (const QFileInfo &file : files)
+        {
+            const QString id = file.completeBaseName();
+            if (mEntries.contains(id))
+                continue; // hidden by a file in a directory with higher precedence
+
+            Entry entry;
+            entry.fileName = file.canonicalFilePath();
+            auto old = oldEntries.constFind(id);
+            if (old != oldEntries.cend() && old->fileName == entry.fileName)
+                entry = *old;
+
+            mEntries.insert(id, entry);
+            mIds << id;
+        }
+    }
+}
+
+
+/************************************************
+
+ ************************************************/
+const LXQt::PluginInfo &PluginInfoIndex::load(Entry &entry)
+{
+    const QDateTime lastModified = QFileInfo(entry.fileName).lastModified();
+    if (entry.lastModified.isValid() && entry.lastModified == lastModified)
+        return entry.info;
+
+    LXQt::PluginInfo info;
+    if (info.load(entry.fileName) && info.isValid() && info.serviceType() == QLatin1String(PLUGIN_SERVICE_TYPE))
+        entry.info = info;
+    else
+        entry.info = LXQt::PluginInfo();
+    entry.lastModified = lastModified;
+    return entry.info;
+}
+
+
+/************************************************
+
+ ************************************************/
+LXQt::PluginInfo PluginInfoIndex::find(const QStringList &desktopDirs, const QString &id)
+{
+    QMutexLocker locker(&mMutex);
+    update(desktopDirs);
+
+    auto it = mEntries.find(id);
+    if (it == mEntries.end())
+        return LXQt::PluginInfo();
+    return load(*it);
+}
+
+
+/************************************************
+
+ ************************************************/
+LXQt::PluginInfoList PluginInfoIndex::all(const QStringList &desktopDirs)
+{
+    QMutexLocker locker(&mMutex);
+    update(desktopDirs);
+
+    LXQt::PluginInfoList list;
+    for (const QString &id : std::as_const(mIds))
+    {
+        const LXQt::PluginInfo &info = load(mEntries[id]);
+        if (info.isValid())
+            list << info;
+    }
+    return list;
+}
@@ -0,0 +1,96 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * LXQt - a lightweight, Qt based, desktop toolset
+ * https://lxqt.org
+ *
+ * Copyright: 2024 LXQt team
+ *
+ * This program or library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef PLUGININFOINDEX_H
+#define PLUGININFOINDEX_H
+
+#include <LXQt/PluginInfo>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+
+/*!
+ * \brief The PluginInfoIndex class is a process wide index of the plugin
+ * .desktop files. It replaces repeated LXQt::PluginInfo::search() calls,
+ * each of which lists and parses all the plugin directories again.
+ *
+ * The directories are listed once and the files are keyed by plugin id,
+ * with the same precedence as LXQt::PluginInfo::search(): a file in an
+ * earlier directory hides a file with the same name in a later one.
+ * A file is only parsed when its plugin is asked for, so a panel start
+ * parses just the configured plugins.
+ *
+ * The listing is redone when the modification time of a directory changes
+ * and a file is parsed again when its own modification time changes.
+ *
+ * The index may be used from several threads, which allows parsing the
+ * files of deferred plugins ahead of time (see PanelPluginsModel).
+ */
+class PluginInfoIndex
+{
+public:
+    static PluginInfoIndex *instance();
+
+    /*!
+     * \brief The directories searched for the plugin .desktop files, in
+     * the order of precedence.
+     */
+    static QStringList desktopDirs();
+
+    /*!
+     * \brief Returns the plugin with the given id, or an invalid
+     * LXQt::PluginInfo if there is none.
+     */
+    LXQt::PluginInfo find(const QStringList &desktopDirs, const QString &id);
+
+    /*!
+     * \brief Returns all the plugins found in desktopDirs.
+     */
+    LXQt::PluginInfoList all(const QStringList &desktopDirs);
+
+private:
+    PluginInfoIndex() = default;
+    Q_DISABLE_COPY(PluginInfoIndex)
+
+    struct Entry
+    {
+        QString fileName;
+        QDateTime lastModified; //!< of the parsed file, invalid if not parsed yet
+        LXQt::PluginInfo info;
+    };
+
+    void update(const QStringList &desktopDirs);
+    const LXQt::PluginInfo &load(Entry &entry);
+
+    QMutex mMutex;
+    QStringList mDirs;
+    QList<QDateTime> mDirsLastModified;
+    QStringList mIds; //!< in the order of the directory listing
+    QHash<QString, Entry> mEntries;
+};
+
+#endif // PLUGININFOINDEX_H
@@ -28,6 +28,9 @@
 #include "pluginsettings.h"
 #include "pluginsettings_p.h"
 #include <LXQt/Settings>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
 #include <memory>
 
 class PluginSettingsPrivate
@@ -40,6 +43,10 @@ public:
         mSettings->beginGroup(mGroup);
         mOldSettings = std::make_unique<LXQt::SettingsCache>(mSettings);
         mSettings->endGroup();
+        load();
+
+        mFlushTimer.setSingleShot(true);
+        mFlushTimer.setInterval(0);
     }
 
     QString prefix() const;
@@ -47,11 +54,31 @@ public:
     {
         return mGroup + QStringLiteral("/") + prefix();
     }
+    //! The key relative to mGroup, as used by the snapshot
+    QString key(const QString &name) const;
+    static bool isInGroup(const QString &key, const QString &group);
+
+    void load();
+    void flush();
+    void discardPending();
+    QStringList changedKeys(const QHash<QString, QVariant> &oldValues) const;
 
     LXQt::Settings *mSettings;
     std::unique_ptr<LXQt::SettingsCache> mOldSettings;
     QString mGroup;
     QStringList mSubGroups;
+
+    // Snapshot of all the values of mGroup, the reads never touch mSettings.
+    // The writes are collected and passed to mSettings once per event loop
+    // pass; mSettings saves them to the disk later, as before.
+    QHash<QString, QVariant> mValues;
+    QHash<QString, QVariant> mPendingValues;
+    QSet<QString> mPendingRemovals; //!< applied before mPendingValues
+    QTimer mFlushTimer;
+
+    int mTransactions = 0;
+    bool mTransactionChanged = false;
+    QStringList mTransactionKeys;
 };
 
 QString PluginSettingsPrivate::prefix() const
@@ -61,12 +88,87 @@ QString PluginSettingsPrivate::prefix() const
     return QString();
 }
 
+QString PluginSettingsPrivate::key(const QString &name) const
+{
+    const QString pre = prefix();
+    if (pre.isEmpty())
+        return name;
+    if (name.isEmpty())
+        return pre;
+    return pre + QLatin1Char('/') + name;
+}
+
+bool PluginSettingsPrivate::isInGroup(const QString &key, const QString &group)
+{
+    return group.isEmpty()
+        || key == group
+        || (key.startsWith(group) && key.at(group.size()) == QLatin1Char('/'));
+}
+
+void PluginSettingsPrivate::load()
+{
+    mValues.clear();
+    mSettings->beginGroup(mGroup);
+    const QStringList keys = mSettings->allKeys();
+    for (const QString &key : keys)
+        mValues.insert(key, mSettings->value(key));
+    mSettings->endGroup();
+}
+
+void PluginSettingsPrivate::flush()
+{
+    mFlushTimer.stop();
+    if (mPendingRemovals.isEmpty() && mPendingValues.isEmpty())
+        return;
+
+    mSettings->beginGroup(mGroup);
+    for (const QString &key : std::as_const(mPendingRemovals))
+        mSettings->remove(key);
+    for (auto it = mPendingValues.cbegin(), it_end = mPendingValues.cend(); it != it_end; ++it)
+        mSettings->setValue(it.key(), it.value());
+    mSettings->endGroup();
+
+    discardPending();
+}
+
+void PluginSettingsPrivate::discardPending()
+{
+    mFlushTimer.stop();
+    mPendingRemovals.clear();
+    mPendingValues.clear();
+}
+
+QStringList PluginSettingsPrivate::changedKeys(const QHash<QString, QVariant> &oldValues) const
+{
+    QStringList keys;
+    for (auto it = mValues.cbegin(), it_end = mValues.cend(); it != it_end; ++it)
+    {
+        auto old = oldValues.constFind(it.key());
+        if (old == oldValues.cend() || *old != it.value())
+            keys << it.key();
+    }
+    for (auto it = oldValues.cbegin(), it_end = oldValues.cend(); it != it_end; ++it)
+    {
+        if (!mValues.contains(it.key()))
+            keys << it.key();
+    }
+    return keys;
+}
+
 PluginSettings::PluginSettings(LXQt::Settings* settings, const QString &group, QObject *parent)
     : QObject(parent)
     , d_ptr(new PluginSettingsPrivate{settings, group})
 {
     Q_D(PluginSettings);
-    connect(d->mSettings, &LXQt::Settings::settingsChangedFromExternal, this, &PluginSettings::settingsChanged);
+    connect(&d->mFlushTimer, &QTimer::timeout, this, [d] { d->flush(); });
+    connect(d->mSettings, &LXQt::Settings::settingsChangedFromExternal, this, [this, d] {
+        d->flush();
+        const QHash<QString, QVariant> oldValues = d->mValues;
+        d->load();
+        const QStringList keys = d->changedKeys(oldValues);
+        if (!keys.isEmpty())
+            notify(keys);
+    });
 }
 
 QString PluginSettings::group() const
@@ -75,47 +177,76 @@ QString PluginSettings::group() const
     return d->mGroup;
 }
 
-PluginSettings::~PluginSettings() = default;
+PluginSettings::~PluginSettings()
+{
+    Q_D(PluginSettings);
+    d->flush();
+}
 
 QVariant PluginSettings::value(const QString &key, const QVariant &defaultValue) const
 {
     Q_D(const PluginSettings);
-    d->mSettings->beginGroup(d->fullPrefix());
-    QVariant value = d->mSettings->value(key, defaultValue);
-    d->mSettings->endGroup();
-    return value;
+    auto it = d->mValues.constFind(d->key(key));
+    if (it == d->mValues.cend())
+        return defaultValue;
+    return *it;
 }
 
 void PluginSettings::setValue(const QString &key, const QVariant &value)
 {
     Q_D(PluginSettings);
-    d->mSettings->beginGroup(d->fullPrefix());
-    d->mSettings->setValue(key, value);
-    d->mSettings->endGroup();
-    emit settingsChanged();
+    const QString fullKey = d->key(key);
+    auto it = d->mValues.find(fullKey);
+    if (it != d->mValues.end() && *it == value)
+        return; // nothing changed, nothing to notify
+
+    d->mValues.insert(fullKey, value);
+    d->mPendingValues.insert(fullKey, value);
+    d->mFlushTimer.start();
+
+    notify({fullKey});
 }
 
 void PluginSettings::remove(const QString &key)
 {
     Q_D(PluginSettings);
-    d->mSettings->beginGroup(d->fullPrefix());
-    d->mSettings->remove(key);
-    d->mSettings->endGroup();
-    emit settingsChanged();
+    const QString fullKey = d->key(key);
+
+    QStringList removed;
+    for (auto it = d->mValues.begin(); it != d->mValues.end();)
+    {
+        if (PluginSettingsPrivate::isInGroup(it.key(), fullKey))
+        {
+            removed << it.key();
+            it = d->mValues.erase(it);
+        }
+        else
+            ++it;
+    }
+    for (auto it = d->mPendingValues.begin(); it != d->mPendingValues.end();)
+    {
+        if (PluginSettingsPrivate::isInGroup(it.key(), fullKey))
+            it = d->mPendingValues.erase(it);
+        else
+            ++it;
+    }
+    d->mPendingRemovals.insert(fullKey);
+    d->mFlushTimer.start();
+
+    if (!removed.isEmpty())
+        notify(removed);
 }
 
 bool PluginSettings::contains(const QString &key) const
 {
     Q_D(const PluginSettings);
-    d->mSettings->beginGroup(d->fullPrefix());
-    bool ret = d->mSettings->contains(key);
-    d->mSettings->endGroup();
-    return ret;
+    return d->mValues.contains(d->key(key));
 }
 
 QList<QMap<QString, QVariant> > PluginSettings::readArray(const QString& prefix)
 {
     Q_D(PluginSettings);
+    d->flush();
     d->mSettings->beginGroup(d->fullPrefix());
     QList<QMap<QString, QVariant> > array;
     int size = d->mSettings->beginReadArray(prefix);
@@ -136,6 +267,7 @@ QList<QMap<QString, QVariant> > PluginSettings::readArray(const QString& prefix)
 void PluginSettings::setArray(const QString &prefix, const QList<QMap<QString, QVariant> > &hashList)
 {
     Q_D(PluginSettings);
+    d->flush();
     d->mSettings->beginGroup(d->fullPrefix());
     d->mSettings->beginWriteArray(prefix);
     int size = hashList.size();
@@ -151,29 +283,38 @@ void PluginSettings::setArray(const QString &prefix, const QList<QMap<QString, Q
     }
     d->mSettings->endArray();
     d->mSettings->endGroup();
-    emit settingsChanged();
+    const QHash<QString, QVariant> oldValues = d->mValues;
+    d->load();
+    const QStringList keys = d->changedKeys(oldValues);
+    if (!keys.isEmpty())
+        notify(keys);
 }
 
 void PluginSettings::clear()
 {
     Q_D(PluginSettings);
+    d->discardPending();
+    const QStringList keys = d->mValues.keys();
+    d->mValues.clear();
     d->mSettings->beginGroup(d->mGroup);
     d->mSettings->clear();
     d->mSettings->endGroup();
-    emit settingsChanged();
+    notify(keys);
 }
 
 void PluginSettings::sync()
 {
     Q_D(PluginSettings);
+    d->flush();
     d->mSettings->sync();
     storeToCache();
-    emit settingsChanged();
+    notify(QStringList());
 }
 
 QStringList PluginSettings::allKeys() const
 {
     Q_D(const PluginSettings);
+    const_cast<PluginSettingsPrivate *>(d)->flush();
     d->mSettings->beginGroup(d->fullPrefix());
     QStringList keys = d->mSettings->allKeys();
     d->mSettings->endGroup();
@@ -183,6 +324,7 @@ QStringList PluginSettings::allKeys() const
 QStringList PluginSettings::childGroups() const
 {
     Q_D(const PluginSettings);
+    const_cast<PluginSettingsPrivate *>(d)->flush();
     d->mSettings->beginGroup(d->fullPrefix());
     QStringList groups = d->mSettings->childGroups();
     d->mSettings->endGroup();
@@ -205,21 +347,67 @@ void PluginSettings::endGroup()
 void PluginSettings::loadFromCache()
 {
     Q_D(PluginSettings);
+    d->discardPending();
     d->mSettings->beginGroup(d->mGroup);
     d->mSettings->remove(QString{});
     d->mOldSettings->loadToSettings();
     d->mSettings->endGroup();
-    emit settingsChanged();
+    const QHash<QString, QVariant> oldValues = d->mValues;
+    d->load();
+    const QStringList keys = d->changedKeys(oldValues);
+    if (!keys.isEmpty())
+        notify(keys);
 }
 
 void PluginSettings::storeToCache()
 {
     Q_D(PluginSettings);
+    d->flush();
     d->mSettings->beginGroup(d->mGroup);
     d->mOldSettings = std::make_unique<LXQt::SettingsCache>(d->mSettings);
     d->mSettings->endGroup();
 }
 
+void PluginSettings::beginTransaction()
+{
+    Q_D(PluginSettings);
+    ++d->mTransactions;
+}
+
+void PluginSettings::commitTransaction()
+{
+    Q_D(PluginSettings);
+    if (d->mTransactions == 0)
+        return;
+    if (--d->mTransactions > 0 || !d->mTransactionChanged)
+        return;
+
+    d->mTransactionChanged = false;
+    QStringList keys;
+    keys.swap(d->mTransactionKeys);
+    notify(keys);
+}
+
+void PluginSettings::notify(const QStringList &keys)
+{
+    Q_D(PluginSettings);
+    if (d->mTransactions > 0)
+    {
+        d->mTransactionChanged = true;
+        for (const QString &key : keys)
+        {
+            if (!d->mTransactionKeys.contains(key))
+                d->mTransactionKeys << key;
+        }
+        return;
+    }
+
+    for (const QString &key : keys)
+        emit valueChanged(key, d->mValues.value(key));
+    emit keysChanged(keys);
+    emit settingsChanged();
+}
+
 PluginSettings* PluginSettingsFactory::create(LXQt::Settings *settings, const QString &group, QObject *parent/* = nullptr*/)
 {
     return new PluginSettings{settings, group, parent};
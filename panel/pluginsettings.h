@@ -45,6 +45,10 @@ class PluginSettingsPrivate;
  * Settings for particular plugin. This object/class can be used similarly as \sa QSettings.
  * Object cannot be constructed directly (it is the panel's responsibility to construct it for each plugin).
  *
+ * The values of the plugin are read once and kept in memory, so value() and contains()
+ * are cheap enough for periodic updates. Writes are passed to the underlying settings
+ * at the end of the current event loop pass (or by sync()).
+ *
  *
  * \note
  * We are relying here on so called "back linking" (calling a function defined in executable
@@ -83,12 +87,45 @@ public:
     void loadFromCache();
     void storeToCache();
 
+    /*!
+     * \brief Starts collecting changes: until the matching
+     * commitTransaction(), the values are changed as usual, but no signal is
+     * emitted. Transactions may be nested, only the outermost one notifies.
+     *
+     * A config dialog writing many keys should wrap them in a transaction,
+     * so that the plugin applies the new settings once.
+     */
+    void beginTransaction();
+    /*!
+     * \brief Ends a transaction. If anything changed, valueChanged() is
+     * emitted for each changed key, then keysChanged() and settingsChanged()
+     * are emitted once.
+     */
+    void commitTransaction();
+
 signals:
+    /*!
+     * \brief Emitted when any value was changed, removed or reloaded.
+     * Writing the value a key already has does not emit it.
+     */
     void settingsChanged();
+    /*!
+     * \brief Emitted for each key whose value was changed or removed (then
+     * \p value is invalid). \p key is relative to group(), including any
+     * subgroup that was active while writing.
+     */
+    void valueChanged(const QString &key, const QVariant &value);
+    /*!
+     * \brief Emitted right before settingsChanged() with the keys that
+     * changed (relative to group()); the list is empty if that is unknown.
+     */
+    void keysChanged(const QStringList &keys);
 
 private:
     explicit PluginSettings(LXQt::Settings *settings, const QString &group, QObject *parent = nullptr);
 
+    void notify(const QStringList &keys);
+
 private:
     std::unique_ptr<PluginSettingsPrivate> d_ptr;
     Q_DECLARE_PRIVATE(PluginSettings)
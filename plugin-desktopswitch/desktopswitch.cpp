@@ -80,7 +80,7 @@ DesktopSwitch::DesktopSwitch(const ILXQtPanelPluginStartupInfo &startupInfo) :
     connect(mBackend, &ILXQtAbstractWMInterface::currentWorkspaceChanged, this, &DesktopSwitch::onCurrentDesktopChanged);
     connect(mBackend, &ILXQtAbstractWMInterface::workspaceNameChanged,    this, &DesktopSwitch::onDesktopNamesChanged);
 
-    connect(mBackend, &ILXQtAbstractWMInterface::windowPropertyChanged, this, &DesktopSwitch::onWindowChanged);
+    connect(mBackend, &ILXQtAbstractWMInterface::windowSnapshotChanged, this, &DesktopSwitch::onWindowChanged);
     connect(mBackend, &ILXQtAbstractWMInterface::windowRemoved, this, &DesktopSwitch::onWindowRemoved);
 }
 
@@ -123,26 +123,26 @@ void DesktopSwitch::shortcutRegistered()
     }
 }
 
-void DesktopSwitch::onWindowChanged(WId id, int prop)
+void DesktopSwitch::onWindowChanged(WId id, int props, const LXQtTaskBarWindowSnapshot &snapshot)
 {
-    if (prop == int(LXQtTaskBarWindowProperty::State)
-        || prop == int(LXQtTaskBarWindowProperty::Urgency)
-        || prop == int(LXQtTaskBarWindowProperty::Workspace))
+    if (props & (windowPropertyBit(LXQtTaskBarWindowProperty::State)
+                 | windowPropertyBit(LXQtTaskBarWindowProperty::Urgency)
+                 | windowPropertyBit(LXQtTaskBarWindowProperty::Workspace)))
     {
-        int desktop = mBackend->getWindowWorkspace(id);
+        int desktop = snapshot.workspace;
         if (desktop == mBackend->onAllWorkspacesEnum())
             return;
-        if (prop == int(LXQtTaskBarWindowProperty::Workspace))
+        if (props & windowPropertyBit(LXQtTaskBarWindowProperty::Workspace))
         { // remove the urgent hint from desktops that do not contain the window
             const auto buttons = m_buttons->buttons();
             for (auto button : buttons)
             {
-                qobject_cast<DesktopSwitchButton*>(button)->setUrgencyHint(id, desktop != m_buttons->id(button) + 1 ? false : mBackend->applicationDemandsAttention(id));
+                qobject_cast<DesktopSwitchButton*>(button)->setUrgencyHint(id, desktop != m_buttons->id(button) + 1 ? false : snapshot.demandsAttention);
             }
         }
         else if (auto button = qobject_cast<DesktopSwitchButton *>(m_buttons->button(desktop - 1)))
         { // set the urgent hint based on whether the window demands attention
-            button->setUrgencyHint(id, mBackend->applicationDemandsAttention(id));
+            button->setUrgencyHint(id, snapshot.demandsAttention);
         }
     }
 }
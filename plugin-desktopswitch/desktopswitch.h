@@ -42,6 +42,7 @@ class GridLayout;
 }
 
 class ILXQtAbstractWMInterface;
+struct LXQtTaskBarWindowSnapshot;
 
 class DesktopSwitchWidget: public QFrame
 {
@@ -96,7 +97,7 @@ private slots:
     virtual void settingsChanged();
     void registerShortcuts();
     void shortcutRegistered();
-    void onWindowChanged(WId id, int prop);
+    void onWindowChanged(WId id, int props, const LXQtTaskBarWindowSnapshot &snapshot);
     void onWindowRemoved(WId id);
 };
 
@@ -110,6 +110,7 @@ void LXQtSensorsConfiguration::saveSettings()
     if (mLockSettingChanges)
         return;
 
+    settings().beginTransaction();
     settings().setValue(QStringLiteral("updateInterval"), ui->updateIntervalSB->value());
     settings().setValue(QStringLiteral("tempBarWidth"), ui->tempBarWidthSB->value());
 
@@ -157,6 +158,7 @@ void LXQtSensorsConfiguration::saveSettings()
 
     settings().setValue(QStringLiteral("warningAboutHighTemperature"),
                        ui->warningAboutHighTemperatureChB->isChecked());
+    settings().commitTransaction();
 }
 
 void LXQtSensorsConfiguration::changeProgressBarColor()
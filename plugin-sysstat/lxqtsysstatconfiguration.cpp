@@ -153,6 +153,7 @@ void LXQtSysStatConfiguration::saveSettings()
     if (mLockSettingChanges)
         return;
 
+    settings().beginTransaction();
     settings().setValue(QStringLiteral("graph/useThemeColours"), ui->useThemeColoursRB->isChecked());
     settings().setValue(QStringLiteral("graph/updateInterval"), ui->intervalSB->value());
     settings().setValue(QStringLiteral("graph/minimalSize"), ui->sizeSB->value());
@@ -173,6 +174,7 @@ void LXQtSysStatConfiguration::saveSettings()
     settings().setValue(QStringLiteral("net/maximumSpeed"), PluginSysStat::netSpeedToString(ui->maximumHS->value()));
     settings().setValue(QStringLiteral("net/logarithmicScale"), ui->logarithmicCB->isChecked());
     settings().setValue(QStringLiteral("net/logarithmicScaleSteps"), ui->logScaleSB->value());
+    settings().commitTransaction();
 }
 
 void LXQtSysStatConfiguration::on_typeCOB_currentIndexChanged(int index)
@@ -212,6 +214,7 @@ void LXQtSysStatConfiguration::coloursChanged()
 {
     const LXQtSysStatColours::Colours &colours = mColoursDialog->colours();
 
+    settings().beginTransaction();
     settings().setValue(QStringLiteral("grid/colour"),  colours[QStringLiteral("grid")].name());
     settings().setValue(QStringLiteral("title/colour"), colours[QStringLiteral("title")].name());
 
@@ -228,6 +231,7 @@ void LXQtSysStatConfiguration::coloursChanged()
 
     settings().setValue(QStringLiteral("net/receivedColour"),    colours[QStringLiteral("netReceived")].name());
     settings().setValue(QStringLiteral("net/transmittedColour"), colours[QStringLiteral("netTransmitted")].name());
+    settings().commitTransaction();
 }
 
 void LXQtSysStatConfiguration::on_customColoursB_clicked()
@@ -41,6 +41,8 @@
 #include <QFlag>
 #include <QTimer>
 
+#include <algorithm>
+
 #include "../panel/ilxqtpanelplugin.h"
 #include "../panel/pluginsettings.h"
 
@@ -68,6 +70,7 @@ LXQtTaskBar::LXQtTaskBar(ILXQtPanelPlugin *plugin, QWidget *parent) :
     mRaiseOnCurrentDesktop(true),
     mShowOnlyOneDesktopTasks(false),
     mShowDesktopNum(0),
+    mCurrentWorkspace(0),
     mShowOnlyCurrentScreenTasks(false),
     mShowOnlyMinimizedTasks(false),
     mAutoRotate(true),
@@ -82,6 +85,11 @@ LXQtTaskBar::LXQtTaskBar(ILXQtPanelPlugin *plugin, QWidget *parent) :
     mStyle(new LeftAlignedTextStyle()),
     mBackend(nullptr)
 {
+    mIconGeometryTimer = new QTimer(this);
+    mIconGeometryTimer->setSingleShot(true);
+    mIconGeometryTimer->setInterval(100);
+    connect(mIconGeometryTimer, &QTimer::timeout, this, &LXQtTaskBar::publishIconGeometries);
+
     setStyle(mStyle);
     mLayout = new LXQt::GridLayout(this);
     setLayout(mLayout);
@@ -104,7 +112,12 @@ LXQtTaskBar::LXQtTaskBar(ILXQtPanelPlugin *plugin, QWidget *parent) :
     connect(mSignalMapper, &QSignalMapper::mappedInt, this, &LXQtTaskBar::activateTask);
     QTimer::singleShot(0, this, &LXQtTaskBar::registerShortcuts);
 
-    connect(mBackend, &ILXQtAbstractWMInterface::windowPropertyChanged, this, &LXQtTaskBar::onWindowChanged);
+    // the groups are told about these by the taskbar, only if they are concerned
+    mCurrentWorkspace = mBackend->getCurrentWorkspace();
+    connect(mBackend, &ILXQtAbstractWMInterface::currentWorkspaceChanged, this, &LXQtTaskBar::onCurrentWorkspaceChanged);
+    connect(mBackend, &ILXQtAbstractWMInterface::activeWindowChanged, this, &LXQtTaskBar::onActiveWindowChanged);
+
+    connect(mBackend, &ILXQtAbstractWMInterface::windowSnapshotChanged, this, &LXQtTaskBar::onWindowChanged);
     connect(mBackend, &ILXQtAbstractWMInterface::windowAdded, this, &LXQtTaskBar::onWindowAdded);
     connect(mBackend, &ILXQtAbstractWMInterface::windowRemoved, this, &LXQtTaskBar::onWindowRemoved);
 
@@ -232,6 +245,7 @@ void LXQtTaskBar::groupBecomeEmptySlot()
     LXQtTaskGroup * const group = qobject_cast<LXQtTaskGroup*>(sender());
     Q_ASSERT(group);
 
+    unregisterGroup(group);
     for (auto i = mKnownWindows.begin(); mKnownWindows.end() != i; )
     {
         if (group == *i)
@@ -248,10 +262,11 @@ void LXQtTaskBar::groupBecomeEmptySlot()
  ************************************************/
 void LXQtTaskBar::addWindow(WId window)
 {
-    if (mExcludedList.contains(mBackend->getWindowClass(window), Qt::CaseInsensitive))
+    const QString window_class = mBackend->getWindowClass(window);
+    if (mExcludedList.contains(window_class, Qt::CaseInsensitive))
         return;
     // If grouping disabled group behaves like regular button
-    const QString group_id = mGroupingEnabled ? mBackend->getWindowClass(window) : QString::number(window);
+    const QString group_id = mGroupingEnabled ? window_class : QString::number(window);
 
     LXQtTaskGroup *group = nullptr;
     auto i_group = mKnownWindows.find(window);
@@ -265,16 +280,7 @@ void LXQtTaskBar::addWindow(WId window)
 
     //check if window belongs to some existing group
     if (!group && mGroupingEnabled)
-    {
-        for (auto i = mKnownWindows.cbegin(), i_e = mKnownWindows.cend(); i != i_e; ++i)
-        {
-            if ((*i)->groupName() == group_id)
-            {
-                group = *i;
-                break;
-            }
-        }
-    }
+        group = mClassGroups.value(window_class).value(0, nullptr);
 
     if (!group)
     {
@@ -290,31 +296,33 @@ void LXQtTaskBar::addWindow(WId window)
 
         if (mUngroupedNextToExisting)
         {
-            const QString window_class = mBackend->getWindowClass(window);
+            // place it after the last group of the same class
             int src_index = mLayout->count() - 1;
             int dst_index = src_index;
-            for (int i = mLayout->count() - 2; 0 <= i; --i)
-            {
-                LXQtTaskGroup * current_group = qobject_cast<LXQtTaskGroup*>(mLayout->itemAt(i)->widget());
-                if (nullptr != current_group)
-                {
-                    const QString current_class = mBackend->getWindowClass(current_group->groupName().toULong());
-                    if(current_class == window_class)
-                    {
-                        dst_index = i + 1;
-                        break;
-                    }
-                }
-            }
+            int last_index = -1;
+            const auto same_class = mClassGroups.value(window_class);
+            for (LXQtTaskGroup * current_group : same_class)
+                last_index = std::max(last_index, mLayout->indexOf(current_group));
+            if (0 <= last_index)
+                dst_index = last_index + 1;
 
             if (dst_index != src_index)
             {
                 mLayout->moveItem(src_index, dst_index, false);
             }
         }
+        registerGroup(group, window_class);
     }
     mKnownWindows[window] = group;
     group->addWindow(window);
+
+    // a group checks itself when it gets the active window
+    if (group->isChecked() && mActiveGroup != group)
+    {
+        if (mActiveGroup)
+            mActiveGroup->onActiveWindowChanged(mBackend->getActiveWindow());
+        mActiveGroup = group;
+    }
 }
 
 /************************************************
@@ -325,6 +333,8 @@ auto LXQtTaskBar::removeWindow(windowMap_t::iterator pos) -> windowMap_t::iterat
     WId const window = pos.key();
     LXQtTaskGroup * const group = *pos;
     auto ret = mKnownWindows.erase(pos);
+    mIconGeometries.remove(window);
+    mPendingIconGeometries.remove(window);
     group->onWindowRemoved(window);
     return ret;
 }
@@ -332,12 +342,82 @@ auto LXQtTaskBar::removeWindow(windowMap_t::iterator pos) -> windowMap_t::iterat
 /************************************************
 
  ************************************************/
-void LXQtTaskBar::onWindowChanged(WId window, int prop)
+void LXQtTaskBar::setIconGeometry(WId window, const QRect &rect)
+{
+    auto published = mIconGeometries.constFind(window);
+    if (published != mIconGeometries.cend() && *published == rect)
+    {
+        mPendingIconGeometries.remove(window);
+        return;
+    }
+
+    mPendingIconGeometries.insert(window, rect);
+    // wait until the layout (or an animation of it) settles
+    mIconGeometryTimer->start();
+}
+
+/************************************************
+
+ ************************************************/
+void LXQtTaskBar::publishIconGeometries()
 {
-    auto i = mKnownWindows.find(window);
-    if (mKnownWindows.end() != i)
+    for (auto i = mPendingIconGeometries.cbegin(), i_e = mPendingIconGeometries.cend(); i != i_e; ++i)
     {
-        if (!(*i)->onWindowChanged(window, LXQtTaskBarWindowProperty(prop)))
+        mBackend->refreshIconGeometry(i.key(), i.value());
+        mIconGeometries.insert(i.key(), i.value());
+    }
+    mPendingIconGeometries.clear();
+}
+
+/************************************************
+
+ ************************************************/
+void LXQtTaskBar::registerGroup(LXQtTaskGroup *group, const QString &windowClass)
+{
+    mClassGroups[windowClass].append(group);
+    mGroupClasses.insert(group, windowClass);
+}
+
+/************************************************
+
+ ************************************************/
+void LXQtTaskBar::unregisterGroup(LXQtTaskGroup *group)
+{
+    auto i = mGroupClasses.find(group);
+    if (mGroupClasses.end() == i)
+        return;
+
+    auto groups = mClassGroups.find(*i);
+    groups->removeOne(group);
+    if (groups->isEmpty())
+        mClassGroups.erase(groups);
+    mGroupClasses.erase(i);
+}
+
+/************************************************
+
+ ************************************************/
+void LXQtTaskBar::onWindowChanged(WId window, int props, const LXQtTaskBarWindowSnapshot &snapshot)
+{
+    for (int prop = int(LXQtTaskBarWindowProperty::Title); prop <= int(LXQtTaskBarWindowProperty::Workspace); ++prop)
+    {
+        if (!(props & windowPropertyBit(LXQtTaskBarWindowProperty(prop))))
+            continue;
+
+        auto i = mKnownWindows.find(window);
+        if (mKnownWindows.end() == i)
+            return;
+
+        // an ungrouped button keeps its window, but its class is indexed
+        if (!mGroupingEnabled && prop == int(LXQtTaskBarWindowProperty::WindowClass)
+                && mGroupClasses.value(*i) != snapshot.windowClass)
+        {
+            LXQtTaskGroup * const group = *i;
+            unregisterGroup(group);
+            registerGroup(group, snapshot.windowClass);
+        }
+
+        if (!(*i)->onWindowChanged(window, LXQtTaskBarWindowProperty(prop), snapshot))
         {
             // window is removed from a group because of class change, so we should add it again
             addWindow(window);
@@ -364,6 +444,39 @@ void LXQtTaskBar::onWindowRemoved(WId window)
     }
 }
 
+/************************************************
+
+ ************************************************/
+void LXQtTaskBar::onActiveWindowChanged(WId window)
+{
+    // only the group which was active and the one of the new active window change;
+    // the former is not looked up by window, which may already be removed or regrouped
+    LXQtTaskGroup * const current = mKnownWindows.value(window, nullptr);
+    if (mActiveGroup && mActiveGroup != current)
+        mActiveGroup->onActiveWindowChanged(window);
+    if (current)
+        current->onActiveWindowChanged(window);
+    mActiveGroup = current;
+}
+
+/************************************************
+
+ ************************************************/
+void LXQtTaskBar::onCurrentWorkspaceChanged(int idx)
+{
+    mCurrentWorkspace = idx;
+
+    // the groups only depend on the current workspace when limited to it
+    if (!mShowOnlyOneDesktopTasks || 0 != mShowDesktopNum)
+        return;
+
+    for (int i = 0; i < mLayout->count(); ++i)
+    {
+        if (LXQtTaskGroup * group = qobject_cast<LXQtTaskGroup*>(mLayout->itemAt(i)->widget()))
+            group->onDesktopChanged(idx);
+    }
+}
+
 /************************************************
 
  ************************************************/
@@ -474,6 +587,8 @@ void LXQtTaskBar::settingsChanged()
             }
         }
         mKnownWindows.clear();
+        mClassGroups.clear();
+        mGroupClasses.clear();
     }
 
     if (showOnlyOneDesktopTasksOld != mShowOnlyOneDesktopTasks
@@ -34,7 +34,9 @@
 
 #include <QFrame>
 #include <QBoxLayout>
-#include <QMap>
+#include <QHash>
+#include <QPointer>
+#include <QRect>
 
 #include "../panel/ilxqtpanel.h"
 
@@ -42,12 +44,14 @@ class ILXQtPanel;
 class ILXQtPanelPlugin;
 
 class QSignalMapper;
+class QTimer;
 
 class LXQtTaskGroup;
 
 class LeftAlignedTextStyle;
 
 class ILXQtAbstractWMInterface;
+struct LXQtTaskBarWindowSnapshot;
 
 namespace LXQt {
 class GridLayout;
@@ -74,6 +78,7 @@ public:
     bool raiseOnCurrentDesktop() const { return mRaiseOnCurrentDesktop; }
     bool isShowOnlyOneDesktopTasks() const { return mShowOnlyOneDesktopTasks; }
     int showDesktopNum() const { return mShowDesktopNum; }
+    int currentWorkspace() const { return mCurrentWorkspace; }
     bool isShowOnlyCurrentScreenTasks() const { return mShowOnlyCurrentScreenTasks; }
     bool isShowOnlyMinimizedTasks() const { return mShowOnlyMinimizedTasks; }
     bool isAutoRotate() const { return mAutoRotate; }
@@ -88,6 +93,13 @@ public:
 
     inline ILXQtAbstractWMInterface *getBackend() const { return mBackend; }
 
+    /*!
+     * \brief Sets where the task of a window is shown. The rects are
+     * published to the window manager together once the layout settles,
+     * and only if they differ from the last published ones.
+     */
+    void setIconGeometry(WId window, const QRect &rect);
+
 public slots:
     void settingsChanged();
 
@@ -108,24 +120,35 @@ private slots:
     void refreshPlaceholderVisibility();
     void groupBecomeEmptySlot();
 
-    void onWindowChanged(WId window, int prop);
+    void onWindowChanged(WId window, int props, const LXQtTaskBarWindowSnapshot &snapshot);
     void onWindowAdded(WId window);
     void onWindowRemoved(WId window);
+    void onActiveWindowChanged(WId window);
+    void onCurrentWorkspaceChanged(int idx);
 
     void registerShortcuts();
     void shortcutRegistered();
     void activateTask(int pos);
 
 private:
-    typedef QMap<WId, LXQtTaskGroup*> windowMap_t;
+    typedef QHash<WId, LXQtTaskGroup*> windowMap_t;
 
 private:
     void addWindow(WId window);
     windowMap_t::iterator removeWindow(windowMap_t::iterator pos);
+    void registerGroup(LXQtTaskGroup *group, const QString &windowClass);
+    void publishIconGeometries();
+    void unregisterGroup(LXQtTaskGroup *group);
     void buttonMove(LXQtTaskGroup * dst, LXQtTaskGroup * src, QPoint const & pos);
 
 private:
-    QMap<WId, LXQtTaskGroup*> mKnownWindows; //!< Ids of known windows (mapping to buttons/groups)
+    windowMap_t mKnownWindows; //!< Ids of known windows (mapping to buttons/groups)
+    QHash<QString, QList<LXQtTaskGroup*>> mClassGroups; //!< Groups by the class of their windows
+    QHash<LXQtTaskGroup*, QString> mGroupClasses; //!< Reverse of mClassGroups
+    QHash<WId, QRect> mIconGeometries; //!< Last published icon geometries
+    QHash<WId, QRect> mPendingIconGeometries;
+    QTimer *mIconGeometryTimer;
+    QPointer<LXQtTaskGroup> mActiveGroup; //!< The group last told it has the active window
     LXQt::GridLayout *mLayout;
     QList<GlobalKeyShortcut::Action*> mKeys;
     QSignalMapper *mSignalMapper;
@@ -138,6 +161,7 @@ private:
     bool mRaiseOnCurrentDesktop;
     bool mShowOnlyOneDesktopTasks;
     int mShowDesktopNum;
+    int mCurrentWorkspace;
     bool mShowOnlyCurrentScreenTasks;
     bool mShowOnlyMinimizedTasks;
     bool mAutoRotate;
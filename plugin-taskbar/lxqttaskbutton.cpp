@@ -50,6 +50,8 @@
 #include <QStyleOptionToolButton>
 #include <QScreen>
 
+#include <utility>
+
 #include "../panel/backends/ilxqtabstractwmiface.h"
 
 
@@ -85,6 +87,9 @@ LXQtTaskButton::LXQtTaskButton(const WId window, LXQtTaskBar * taskbar, QWidget
     mPlugin(mParentTaskBar->plugin()),
     mIconSize(mPlugin->panel()->iconSize()),
     mWheelDelta(0),
+    mWorkspace(0),
+    mOnCurrentScreen(true),
+    mMinimized(false),
     mDNDTimer(new QTimer(this)),
     mWheelTimer(new QTimer(this))
 {
@@ -542,6 +547,10 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     }
 
     const LXQtTaskBarWindowState state = mBackend->getWindowState(mWindow);
+    const int actions = mBackend->getSupportedActions(mWindow);
+    auto supportsAction = [actions](LXQtTaskBarBackendAction action) {
+        return (actions & backendActionBit(action)) != 0;
+    };
 
     QMenu * menu = new QMenu(tr("Application"), this);
     menu->setAttribute(Qt::WA_DeleteOnClose);
@@ -578,7 +587,7 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     {
         int winDesk = mBackend->getWindowWorkspace(mWindow);
         QMenu* deskMenu = menu->addMenu(tr("To &Desktop"));
-        deskMenu->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::MoveToDesktop));
+        deskMenu->setEnabled(supportsAction(LXQtTaskBarBackendAction::MoveToDesktop));
 
         a = deskMenu->addAction(tr("&All Desktops"));
         a->setData(mBackend->onAllWorkspacesEnum());
@@ -610,24 +619,24 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     {
         menu->addSeparator();
         a = menu->addAction(tr("Move To N&ext Monitor"));
-        a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::MoveToOutput));
+        a->setEnabled(supportsAction(LXQtTaskBarBackendAction::MoveToOutput));
         connect(a, &QAction::triggered, this, [this] { moveApplicationToPrevNextMonitor(true); });
-        a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::Move) &&
+        a->setEnabled(supportsAction(LXQtTaskBarBackendAction::Move) &&
                       (state != LXQtTaskBarWindowState::FullScreen
-                       || ((state == LXQtTaskBarWindowState::FullScreen) && mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::FullScreen))));
+                       || ((state == LXQtTaskBarWindowState::FullScreen) && supportsAction(LXQtTaskBarBackendAction::FullScreen))));
         a = menu->addAction(tr("Move To &Previous Monitor"));
-        a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::MoveToOutput));
+        a->setEnabled(supportsAction(LXQtTaskBarBackendAction::MoveToOutput));
         connect(a, &QAction::triggered, this, [this] { moveApplicationToPrevNextMonitor(false); });
     }
 
     menu->addSeparator();
     a = menu->addAction(tr("&Move"));
-    a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::Move)
+    a->setEnabled(supportsAction(LXQtTaskBarBackendAction::Move)
                   && state != LXQtTaskBarWindowState::Maximized
                   && state != LXQtTaskBarWindowState::FullScreen);
     connect(a, &QAction::triggered, this, &LXQtTaskButton::moveApplication);
     a = menu->addAction(tr("Resi&ze"));
-    a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::Resize)
+    a->setEnabled(supportsAction(LXQtTaskBarBackendAction::Resize)
                   && state != LXQtTaskBarWindowState::Maximized
                   && state != LXQtTaskBarWindowState::FullScreen);
     connect(a, &QAction::triggered, this, &LXQtTaskButton::resizeApplication);
@@ -636,7 +645,7 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     menu->addSeparator();
 
     a = menu->addAction(tr("Ma&ximize"));
-    a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::Maximize)
+    a->setEnabled(supportsAction(LXQtTaskBarBackendAction::Maximize)
                   && state != LXQtTaskBarWindowState::Maximized
                   && state != LXQtTaskBarWindowState::Hidden);
     a->setData(int(LXQtTaskBarWindowState::Maximized));
@@ -645,14 +654,14 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     if (event->modifiers() & Qt::ShiftModifier)
     {
         a = menu->addAction(tr("Maximize vertically"));
-        a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::MaximizeVertically)
+        a->setEnabled(supportsAction(LXQtTaskBarBackendAction::MaximizeVertically)
                       && state != LXQtTaskBarWindowState::MaximizedVertically
                       && state != LXQtTaskBarWindowState::Hidden);
         a->setData(int(LXQtTaskBarWindowState::MaximizedVertically));
         connect(a, &QAction::triggered, this, &LXQtTaskButton::maximizeApplication);
 
         a = menu->addAction(tr("Maximize horizontally"));
-        a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::MaximizeHorizontally)
+        a->setEnabled(supportsAction(LXQtTaskBarBackendAction::MaximizeHorizontally)
                       && state != LXQtTaskBarWindowState::MaximizedHorizontally
                       && state != LXQtTaskBarWindowState::Hidden);
         a->setData(int(LXQtTaskBarWindowState::MaximizedHorizontally));
@@ -668,7 +677,7 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     connect(a, &QAction::triggered, this, &LXQtTaskButton::deMaximizeApplication);
 
     a = menu->addAction(tr("Mi&nimize"));
-    a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::Minimize)
+    a->setEnabled(supportsAction(LXQtTaskBarBackendAction::Minimize)
                   && state != LXQtTaskBarWindowState::Hidden
                   && state != LXQtTaskBarWindowState::Minimized);
     connect(a, &QAction::triggered, this, &LXQtTaskButton::minimizeApplication);
@@ -676,7 +685,7 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     if (state == LXQtTaskBarWindowState::RolledUp)
     {
         a = menu->addAction(tr("Roll down"));
-        a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::RollUp)
+        a->setEnabled(supportsAction(LXQtTaskBarBackendAction::RollUp)
                       && state != LXQtTaskBarWindowState::Hidden
                       && state != LXQtTaskBarWindowState::Minimized);
         connect(a, &QAction::triggered, this, &LXQtTaskButton::unShadeApplication);
@@ -684,7 +693,7 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     else
     {
         a = menu->addAction(tr("Roll up"));
-        a->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::RollUp)
+        a->setEnabled(supportsAction(LXQtTaskBarBackendAction::RollUp)
                       && state != LXQtTaskBarWindowState::Hidden);
         connect(a, &QAction::triggered, this, &LXQtTaskButton::shadeApplication);
     }
@@ -693,7 +702,7 @@ void LXQtTaskButton::contextMenuEvent(QContextMenuEvent* event)
     menu->addSeparator();
 
     QMenu* layerMenu = menu->addMenu(tr("&Layer"));
-    layerMenu->setEnabled(mBackend->supportsAction(mWindow, LXQtTaskBarBackendAction::MoveToLayer));
+    layerMenu->setEnabled(supportsAction(LXQtTaskBarBackendAction::MoveToLayer));
 
     LXQtTaskBarWindowLayer currentLayer = mBackend->getWindowLayer(mWindow);
 
@@ -742,19 +751,60 @@ void LXQtTaskButton::setUrgencyHint(bool set)
  ************************************************/
 bool LXQtTaskButton::isOnDesktop(int desktop) const
 {
-    int d = mBackend->getWindowWorkspace(mWindow);
-    return d == desktop || d == mBackend->onAllWorkspacesEnum();
+    return mWorkspace == desktop || mWorkspace == mBackend->onAllWorkspacesEnum();
 }
 
 bool LXQtTaskButton::isOnCurrentScreen() const
 {
-    QScreen *screen = parentTaskBar()->screen();
-    return mBackend->isWindowOnScreen(screen, mWindow);
+    return mOnCurrentScreen;
 }
 
 bool LXQtTaskButton::isMinimized() const
 {
-    return mBackend->getWindowState(mWindow) == LXQtTaskBarWindowState::Minimized;
+    return mMinimized;
+}
+
+/************************************************
+ Reads the visibility state of the window from the backend. The screen is
+ only read while the taskbar shows the tasks of its screen only.
+ ************************************************/
+void LXQtTaskButton::updateVisibilityState()
+{
+    mWorkspace = mBackend->getWindowWorkspace(mWindow);
+    mMinimized = mBackend->getWindowState(mWindow) == LXQtTaskBarWindowState::Minimized;
+    mOnCurrentScreen = !mParentTaskBar->isShowOnlyCurrentScreenTasks()
+                       || mBackend->isWindowOnScreen(mParentTaskBar->screen(), mWindow);
+}
+
+/************************************************
+ Updates the visibility state of the window on a change of its properties.
+ Returns true if it changed.
+ ************************************************/
+bool LXQtTaskButton::updateVisibilityState(LXQtTaskBarWindowProperty prop, const LXQtTaskBarWindowSnapshot &snapshot)
+{
+    switch (prop)
+    {
+    case LXQtTaskBarWindowProperty::Workspace:
+        return std::exchange(mWorkspace, snapshot.workspace) != snapshot.workspace;
+
+    case LXQtTaskBarWindowProperty::State:
+    {
+        const bool minimized = snapshot.state == LXQtTaskBarWindowState::Minimized;
+        return std::exchange(mMinimized, minimized) != minimized;
+    }
+
+    case LXQtTaskBarWindowProperty::Geometry:
+    {
+        // the window may have moved to another screen
+        if (!mParentTaskBar->isShowOnlyCurrentScreenTasks())
+            return false;
+        const bool onCurrentScreen = mBackend->isWindowOnScreen(mParentTaskBar->screen(), mWindow);
+        return std::exchange(mOnCurrentScreen, onCurrentScreen) != onCurrentScreen;
+    }
+
+    default:
+        return false;
+    }
 }
 
 Qt::Corner LXQtTaskButton::origin() const
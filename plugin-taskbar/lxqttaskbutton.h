@@ -35,6 +35,7 @@
 #include <QProxyStyle>
 
 #include "../panel/ilxqtpanel.h"
+#include "../panel/backends/lxqttaskbartypes.h"
 
 class QPainter;
 class QPalette;
@@ -71,9 +72,12 @@ public:
     bool hasUrgencyHint() const { return mUrgencyHint; }
     void setUrgencyHint(bool set);
 
+    // The visibility state is cached, see updateVisibilityState()
     bool isOnDesktop(int desktop) const;
     bool isOnCurrentScreen() const;
     bool isMinimized() const;
+    void updateVisibilityState();
+    bool updateVisibilityState(LXQtTaskBarWindowProperty prop, const LXQtTaskBarWindowSnapshot &snapshot);
     void updateText();
 
     Qt::Corner origin() const;
@@ -140,6 +144,11 @@ private:
     int mIconSize;
     int mWheelDelta;
 
+    // Visibility state of the window
+    int mWorkspace;
+    bool mOnCurrentScreen;
+    bool mMinimized;
+
     QString mExplicitlySetText;
 
     // Timer for when draggind something into a button (the button's window
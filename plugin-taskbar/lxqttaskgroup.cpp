@@ -65,10 +65,8 @@ LXQtTaskGroup::LXQtTaskGroup(const QString &groupName, WId window, LXQtTaskBar *
     connect(parent, &LXQtTaskBar::buttonRotationRefreshed,             this, &LXQtTaskGroup::setAutoRotation);
     connect(parent, &LXQtTaskBar::refreshIconGeometry,                 this, &LXQtTaskGroup::refreshIconsGeometry);
     connect(parent, &LXQtTaskBar::buttonStyleRefreshed,                this, &LXQtTaskGroup::setToolButtonsStyle);
-    connect(parent, &LXQtTaskBar::showOnlySettingChanged,              this, &LXQtTaskGroup::refreshVisibility);
+    connect(parent, &LXQtTaskBar::showOnlySettingChanged,              this, &LXQtTaskGroup::onShowOnlySettingChanged);
     connect(parent, &LXQtTaskBar::popupShown,                          this, &LXQtTaskGroup::groupPopupShown);
-    connect(mBackend, &ILXQtAbstractWMInterface::currentWorkspaceChanged, this, &LXQtTaskGroup::onDesktopChanged);
-    connect(mBackend, &ILXQtAbstractWMInterface::activeWindowChanged,   this, &LXQtTaskGroup::onActiveWindowChanged);
 }
 
 /************************************************
@@ -101,7 +99,7 @@ void LXQtTaskGroup::contextMenuEvent(QContextMenuEvent *event)
 void LXQtTaskGroup::closeGroup()
 {
     for (LXQtTaskButton *button : std::as_const(mButtonHash) )
-        if (button->isOnDesktop(mBackend->getCurrentWorkspace()))
+        if (button->isOnDesktop(parentTaskBar()->currentWorkspace()))
             button->closeApplication();
 }
 
@@ -122,6 +120,7 @@ LXQtTaskButton * LXQtTaskGroup::addWindow(WId id)
         setChecked(true);
     }
 
+    btn->updateVisibilityState();
     mButtonHash.insert(id, btn);
     mPopup->addButton(btn);
 
@@ -215,6 +214,17 @@ void LXQtTaskGroup::onDesktopChanged(int /*number*/)
     refreshVisibility();
 }
 
+/************************************************
+
+ ************************************************/
+void LXQtTaskGroup::onShowOnlySettingChanged()
+{
+    // the screens of the windows are only tracked while they are needed
+    for (LXQtTaskButton *btn : std::as_const(mButtonHash))
+        btn->updateVisibilityState();
+    refreshVisibility();
+}
+
 /************************************************
 
  ************************************************/
@@ -388,7 +398,7 @@ void LXQtTaskGroup::refreshVisibility()
     const int showDesktop = taskbar->showDesktopNum();
     for(LXQtTaskButton * btn : std::as_const(mButtonHash))
     {
-        bool visible = taskbar->isShowOnlyOneDesktopTasks() ? btn->isOnDesktop(0 == showDesktop ? mBackend->getCurrentWorkspace() : showDesktop) : true;
+        bool visible = taskbar->isShowOnlyOneDesktopTasks() ? btn->isOnDesktop(0 == showDesktop ? taskbar->currentWorkspace() : showDesktop) : true;
         visible &= taskbar->isShowOnlyCurrentScreenTasks() ? btn->isOnCurrentScreen() : true;
         visible &= taskbar->isShowOnlyMinimizedTasks() ? btn->isMinimized() : true;
         btn->setVisible(visible);
@@ -448,13 +458,13 @@ void LXQtTaskGroup::refreshIconsGeometry()
 
     if (mSingleButton)
     {
-        mBackend->refreshIconGeometry(windowId(), rect);
+        parentTaskBar()->setIconGeometry(windowId(), rect);
         return;
     }
 
     for(LXQtTaskButton *but : std::as_const(mButtonHash))
     {
-        mBackend->refreshIconGeometry(but->windowId(), rect);
+        parentTaskBar()->setIconGeometry(but->windowId(), rect);
         but->setIconSize(QSize(plugin()->panel()->iconSize(), plugin()->panel()->iconSize()));
     }
 }
@@ -618,7 +628,7 @@ void LXQtTaskGroup::wheelEvent(QWheelEvent* event)
 /************************************************
 
  ************************************************/
-bool LXQtTaskGroup::onWindowChanged(WId window, LXQtTaskBarWindowProperty prop)
+bool LXQtTaskGroup::onWindowChanged(WId window, LXQtTaskBarWindowProperty prop, const LXQtTaskBarWindowSnapshot &snapshot)
 {
     // Returns true if the class is preserved
 
@@ -636,17 +646,22 @@ bool LXQtTaskGroup::onWindowChanged(WId window, LXQtTaskBarWindowProperty prop)
         // if class is changed the window won't belong to our group any more
         if (parentTaskBar()->isGroupingEnabled() && prop == LXQtTaskBarWindowProperty::WindowClass)
         {
-            if (mBackend->getWindowClass(windowId()) != mGroupName)
+            if (snapshot.windowClass != mGroupName)
             {
                 onWindowRemoved(window);
                 return false;
             }
         }
-        // window changed virtual desktop or may change screen
-        if ((prop == LXQtTaskBarWindowProperty::Workspace && parentTaskBar()->isShowOnlyOneDesktopTasks()) ||
-            (prop == LXQtTaskBarWindowProperty::Geometry && parentTaskBar()->isShowOnlyCurrentScreenTasks()))
+        // window changed virtual desktop, screen or minimization
+        if (LXQtTaskButton *button = mButtonHash.value(window))
         {
-            needsRefreshVisibility = true;
+            if (button->updateVisibilityState(prop, snapshot)
+                && ((prop == LXQtTaskBarWindowProperty::Workspace && parentTaskBar()->isShowOnlyOneDesktopTasks())
+                    || prop == LXQtTaskBarWindowProperty::Geometry
+                    || (prop == LXQtTaskBarWindowProperty::State && parentTaskBar()->isShowOnlyMinimizedTasks())))
+            {
+                needsRefreshVisibility = true;
+            }
         }
 
         if (prop == LXQtTaskBarWindowProperty::Title)
@@ -664,19 +679,14 @@ bool LXQtTaskGroup::onWindowChanged(WId window, LXQtTaskBarWindowProperty prop)
         {
             set_urgency = true;
             //FIXME: original code here did not consider "demand attention", was it intentional?
-            urgency = mBackend->applicationDemandsAttention(window);
+            urgency = snapshot.demandsAttention;
         }
         if (prop == LXQtTaskBarWindowProperty::State)
         {
             if (!set_urgency)
-                urgency = mBackend->applicationDemandsAttention(window);
+                urgency = snapshot.demandsAttention;
             std::for_each(buttons.begin(), buttons.end(), std::bind(&LXQtTaskButton::setUrgencyHint, std::placeholders::_1, urgency));
             set_urgency = false;
-
-            if (parentTaskBar()->isShowOnlyMinimizedTasks())
-            {
-                needsRefreshVisibility = true;
-            }
         }
         if (set_urgency)
             std::for_each(buttons.begin(), buttons.end(), std::bind(&LXQtTaskButton::setUrgencyHint, std::placeholders::_1, urgency));
@@ -60,7 +60,7 @@ public:
     // if circular is true, then it will go around the list of buttons
     LXQtTaskButton * getNextPrevChildButton(bool next, bool circular);
 
-    bool onWindowChanged(WId window, LXQtTaskBarWindowProperty prop);
+    bool onWindowChanged(WId window, LXQtTaskBarWindowProperty prop, const LXQtTaskBarWindowSnapshot &snapshot);
 
     void setAutoRotation(bool value, ILXQtPanel::Position position);
     Qt::ToolButtonStyle popupButtonStyle() const;
@@ -68,6 +68,10 @@ public:
 
     void setPopupVisible(bool visible = true, bool fast = false);
 
+    // Called by the taskbar for the concerned groups only
+    void onActiveWindowChanged(WId window);
+    void onDesktopChanged(int number);
+
 public slots:
     void onWindowRemoved(WId window);
 
@@ -90,8 +94,7 @@ protected:
 private slots:
     void onClicked(bool checked);
     void onChildButtonClicked();
-    void onActiveWindowChanged(WId window);
-    void onDesktopChanged(int number);
+    void onShowOnlySettingChanged();
 
     void closeGroup();
     void refreshIconsGeometry();
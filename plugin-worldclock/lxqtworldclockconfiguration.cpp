@@ -244,6 +244,8 @@ void LXQtWorldClockConfiguration::saveSettings()
     if (mLockCascadeSettingChanges)
         return;
 
+    settings().beginTransaction();
+
     QString formatType;
     switch (ui->timeFormatCB->currentIndex())
     {
@@ -381,6 +383,8 @@ void LXQtWorldClockConfiguration::saveSettings()
     settings().setValue(QLatin1String("autoRotate"), ui->autorotateCB->isChecked());
     settings().setValue(QL1S("showWeekNumber"), ui->showWeekNumberCB->isChecked());
     settings().setValue(QLatin1String("showTooltip"), ui->showTooltipCB->isChecked());
+
+    settings().commitTransaction();
 }
 
 void LXQtWorldClockConfiguration::timeFormatChanged(int index)